@@ -0,0 +1,126 @@
+#include <iostream>
+#include <vector>
+#include <set>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#include "bron_kerbosch.h"
+#include "graph_generators.h"
+
+using namespace std;
+
+struct BenchmarkFamily {
+    string name;
+    Graph graph;
+};
+
+// The representative workloads; bk_bench --training runs them to collect PGO profiles.
+vector<BenchmarkFamily> make_benchmark_families() {
+    vector<BenchmarkFamily> families;
+    families.push_back({"sparse social (2000, 4)", make_social_graph(2000, 4, 0.6, 7)});
+    families.push_back({"dense G(60, 0.7)", make_random_graph(60, 0.7, 7)});
+    families.push_back({"Moon-Moser k = 8", make_moon_moser_graph(8)});
+    return families;
+}
+
+template <typename PivotPolicy>
+double time_pivot_policy(const string& family_name, const string& policy_name, Graph& g, bool verbose,
+                         PhaseProfiler* profiler) {
+    CliqueSearchOptions options;
+    options.profiler = profiler;
+    CliqueSearchStats stats;
+    auto start = chrono::steady_clock::now();
+    g.find_max_cliques_with_pivot<PivotPolicy>(options, stats);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    if (verbose) {
+        cout << family_name << ", " << policy_name << ": " << ms << " ms, " << stats.nodes << " nodes, "
+             << stats.cliques << " cliques" << endl;
+    }
+    return ms;
+}
+
+double run_pivot_benchmark(vector<BenchmarkFamily>& families, bool verbose, PhaseProfiler* profiler) {
+    if (verbose) cout << "Running time by pivot policy:" << endl;
+    double total_ms = 0;
+    for (auto& family : families) {
+        total_ms += time_pivot_policy<TomitaPivot>(family.name, "Tomita", family.graph, verbose, profiler);
+        total_ms += time_pivot_policy<MaxDegreePivot>(family.name, "max degree", family.graph, verbose, profiler);
+        total_ms += time_pivot_policy<NaudePivot>(family.name, "Naude sampling", family.graph, verbose, profiler);
+        total_ms += time_pivot_policy<FirstVertexPivot>(family.name, "first vertex", family.graph, verbose, profiler);
+        total_ms += time_pivot_policy<RandomPivot>(family.name, "random", family.graph, verbose, profiler);
+        total_ms += time_pivot_policy<NoPivot>(family.name, "no pivot", family.graph, verbose, profiler);
+    }
+    return total_ms;
+}
+
+double run_vertex_ordering_benchmark(vector<BenchmarkFamily>& families, bool verbose, PhaseProfiler* profiler) {
+    if (verbose) cout << "\nSearch tree nodes by vertex ordering:" << endl;
+    const pair<VertexOrdering, string> orderings[] = {{VertexOrdering::VertexId, "vertex id"},
+                                                      {VertexOrdering::DegreeDescending, "degree desc"},
+                                                      {VertexOrdering::DegreeAscending, "degree asc"},
+                                                      {VertexOrdering::CoreAscending, "core asc"},
+                                                      {VertexOrdering::ColorDescending, "color desc"}};
+    double total_ms = 0;
+    for (auto& family : families) {
+        for (const auto& ordering : orderings) {
+            CliqueSearchOptions options;
+            options.ordering = ordering.first;
+            options.profiler = profiler;
+            CliqueSearchStats stats;
+            auto start = chrono::steady_clock::now();
+            family.graph.find_max_cliques(options, stats);
+            total_ms += chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+            if (verbose) {
+                cout << family.name << ", " << ordering.second << ": " << stats.nodes << " nodes, "
+                     << stats.cliques << " cliques" << endl;
+            }
+        }
+    }
+    return total_ms;
+}
+
+int main(int argc, char** argv) {
+    // --training: run the workload quietly (PGO training run).
+    // --repetitions N: repeat the workload and report the best total time, for build comparisons.
+    // --trace FILE: write the phase timers as a Chrome trace; only bk_perf, built with BK_PROFILE,
+    // records any events.
+    bool training = false;
+    int repetitions = 1;
+    const char* trace_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--training") == 0) {
+            training = true;
+        } else if (strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+            repetitions = max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else {
+            cerr << "usage: " << argv[0] << " [--training] [--repetitions N] [--trace FILE]" << endl;
+            return 2;
+        }
+    }
+    vector<BenchmarkFamily> families = make_benchmark_families();
+    // The first repetition is traced.
+    PhaseProfiler profiler;
+    double best_ms = 0;
+    for (int r = 0; r < repetitions; ++r) {
+        bool verbose = !training && r == 0;
+        PhaseProfiler* traced = trace_path && r == 0 ? &profiler : nullptr;
+        double ms = run_pivot_benchmark(families, verbose, traced) +
+                    run_vertex_ordering_benchmark(families, verbose, traced);
+        best_ms = r == 0 ? ms : min(best_ms, ms);
+    }
+    cout << "\nTotal: " << best_ms << " ms" << endl;
+    if (trace_path) {
+        ofstream trace(trace_path);
+        profiler.write_chrome_trace(trace);
+        if (!trace) {
+            cerr << "cannot write " << trace_path << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,434 @@
+#include <iostream>
+#include <vector>
+#include <set>
+#include <string>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include "bron_kerbosch.h"
+#include "graph_io.h"
+#include "twin_reduction.h"
+#include "roaring_bitmap.h"
+#include "sparse_engine.h"
+#include "sorted_vertex_set.h"
+#include "edge_support.h"
+#include "partition_engine.h"
+#include "sorted_output.h"
+
+using namespace std;
+
+static const char* const usage_text =
+    "usage: bk_cli [options] <graph-file | ->\n"
+    "\n"
+    "Enumerates the maximal cliques of a graph.\n"
+    "\n"
+    "input:\n"
+    "  --format F          edgelist, dimacs, metis or mtx (default: from the file extension;\n"
+    "                      edgelist for stdin)\n"
+    "search:\n"
+    "  --engine E          matrix, roaring, sorted or partition (default: matrix); the others\n"
+    "                      keep neighborhoods and candidate sets in compressed bitmaps, sorted\n"
+    "                      arrays or one partitioned vertex array instead of an n x n matrix, for\n"
+    "                      large sparse graphs, and support only the size bounds and --threads\n"
+    "  --pivot P           tomita, maxdegree, first, random, naude or none (default: tomita)\n"
+    "  --ordering O        id, degree-desc, degree-asc, core or color (default: id)\n"
+    "  --threads N         worker threads, 0 for all cores (default: 1)\n"
+    "  --deterministic     write the cliques in the same order for any number of threads,\n"
+    "                      buffering the cliques of subproblems that finish out of order\n"
+    "  --min-size N        only report cliques with at least N vertices\n"
+    "  --max-size N        truncate cliques at N vertices\n"
+    "  --coloring-depth N  use the coloring bound down to depth N\n"
+    "  --top-k K           report only the K largest cliques (single-threaded)\n"
+    "  --edge-support      count the triangles on every edge first: report the edges on none\n"
+    "                      directly and search the k-truss for the larger cliques\n"
+    "  --memory-limit MB   stop once the search's scratch and buffered cliques exceed MB\n"
+    "                      megabytes; the cliques found so far are written and the exit\n"
+    "                      status is 3 (not with --twins)\n"
+    "  --twins             merge twin vertices first and expand the cliques on output\n"
+    "                      (single-threaded; not with --max-size, --coloring-depth or --top-k)\n"
+    "  --families          like --twins, but write each family of twin-swapped cliques as one\n"
+    "                      line, e.g. \"{0,1,2} {3,4,5}\" for the 9 edges of K(3,3); with --count,\n"
+    "                      the cliques are counted without expanding them\n"
+    "output:\n"
+    "  --output FILE       write cliques as text to FILE instead of stdout\n"
+    "  --binary FILE       write cliques in binary: \"BKC1\", then per clique a uint32 size and\n"
+    "                      its uint32 vertex ids, in host byte order\n"
+    "  --sorted            write the cliques in lexicographic order, the same for any number of\n"
+    "                      threads (not with --twins or --top-k)\n"
+    "  --count             only count the cliques\n"
+    "  --stats             print graph size, search counters and timings to stderr\n";
+
+// Buffered clique writer for the text, binary and count-only outputs. It owns its stream and closes
+// it, unless it is stdout.
+class CliqueWriter {
+public:
+    enum class Mode { Text, Binary, Count };
+
+    CliqueWriter(Mode mode, FILE* file) : mode(mode), file(file) {
+        buffer.reserve(buffer_capacity + 4096);
+        if (mode == Mode::Binary) {
+            buffer.append("BKC1", 4);
+        }
+    }
+
+    // Only reached without close() when an error is already propagating, so write errors are dropped.
+    ~CliqueWriter() {
+        if (!file) return;
+        try {
+            flush();
+        } catch (const exception&) {
+        }
+        if (file != stdout) fclose(file);
+    }
+
+    void write(const set<int>& clique) {
+        count++;
+        if (mode == Mode::Count) return;
+        if (mode == Mode::Text) {
+            char digits[16];
+            const char* separator = "";
+            for (int v : clique) {
+                buffer.append(separator);
+                auto result = to_chars(digits, digits + sizeof(digits), v);
+                buffer.append(digits, result.ptr);
+                separator = " ";
+            }
+            buffer.push_back('\n');
+        } else {
+            append_u32(static_cast<uint32_t>(clique.size()));
+            for (int v : clique) {
+                append_u32(static_cast<uint32_t>(v));
+            }
+        }
+        if (buffer.size() >= buffer_capacity) flush();
+    }
+
+    // Writes a family as one text line and counts all of its cliques.
+    void write_family(const CliqueFamily& family) {
+        uint64_t size = family.count();
+        long long room = numeric_limits<long long>::max() - count;
+        count = size > static_cast<uint64_t>(room) ? numeric_limits<long long>::max() : count + static_cast<long long>(size);
+        if (mode == Mode::Count) return;
+        buffer += family.to_string();
+        buffer.push_back('\n');
+        if (buffer.size() >= buffer_capacity) flush();
+    }
+
+    void flush() {
+        if (!buffer.empty() && fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+            throw runtime_error("write failed");
+        }
+        buffer.clear();
+        if (fflush(file) != 0) {
+            throw runtime_error("write failed");
+        }
+    }
+
+    // Flushes and closes the stream, reporting any write error deferred by the C library.
+    void close() {
+        if (!file) return;
+        bool ok = true;
+        try {
+            flush();
+        } catch (const exception&) {
+            ok = false;
+        }
+        FILE* closing = file;
+        file = nullptr;
+        if (closing != stdout && fclose(closing) != 0) ok = false;
+        if (!ok) throw runtime_error("write failed");
+    }
+
+    long long written() const {
+        return count;
+    }
+
+private:
+    static const size_t buffer_capacity = 1 << 20;
+    Mode mode;
+    FILE* file;
+    string buffer;
+    long long count = 0;
+
+    void append_u32(uint32_t value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+};
+
+struct CliOptions {
+    string input;
+    bool format_given = false;
+    GraphFormat format = GraphFormat::EdgeList;
+    string engine = "matrix";
+    string pivot = "tomita";
+    int threads = 1;
+    int top_k = 0;
+    int memory_limit_mb = 0;
+    CliqueSearchOptions search;
+    string output;
+    CliqueWriter::Mode mode = CliqueWriter::Mode::Text;
+    bool stats = false;
+    bool twins = false;
+    bool families = false;
+    bool sorted = false;
+    bool edge_support = false;
+};
+
+[[noreturn]] void usage_error(const string& message) {
+    cerr << "bk_cli: " << message << "\n\n" << usage_text;
+    exit(2);
+}
+
+int parse_int(const string& flag, const char* value) {
+    char* end;
+    long parsed = strtol(value, &end, 10);
+    if (*value == '\0' || *end != '\0' || parsed < 0 || parsed > numeric_limits<int>::max()) {
+        usage_error("invalid value for " + flag + ": " + value);
+    }
+    return static_cast<int>(parsed);
+}
+
+CliOptions parse_arguments(int argc, char** argv) {
+    CliOptions cli;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        auto value = [&]() -> const char* {
+            if (i + 1 >= argc) usage_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--help" || arg == "-h") {
+            cout << usage_text;
+            exit(0);
+        } else if (arg == "--format") {
+            if (!parse_graph_format(value(), cli.format)) usage_error("unknown format");
+            cli.format_given = true;
+        } else if (arg == "--engine") {
+            cli.engine = value();
+            if (cli.engine != "matrix" && cli.engine != "roaring" && cli.engine != "sorted" &&
+                cli.engine != "partition") {
+                usage_error("unknown engine: " + cli.engine);
+            }
+        } else if (arg == "--pivot") {
+            cli.pivot = value();
+        } else if (arg == "--ordering") {
+            string name = value();
+            if (name == "id") cli.search.ordering = VertexOrdering::VertexId;
+            else if (name == "degree-desc") cli.search.ordering = VertexOrdering::DegreeDescending;
+            else if (name == "degree-asc") cli.search.ordering = VertexOrdering::DegreeAscending;
+            else if (name == "core") cli.search.ordering = VertexOrdering::CoreAscending;
+            else if (name == "color") cli.search.ordering = VertexOrdering::ColorDescending;
+            else usage_error("unknown ordering: " + name);
+        } else if (arg == "--threads") {
+            cli.threads = parse_int(arg, value());
+            if (cli.threads == 0) cli.threads = max(1u, thread::hardware_concurrency());
+        } else if (arg == "--deterministic") {
+            cli.search.deterministic = true;
+        } else if (arg == "--min-size") {
+            cli.search.min_size = parse_int(arg, value());
+        } else if (arg == "--max-size") {
+            cli.search.max_size = parse_int(arg, value());
+        } else if (arg == "--coloring-depth") {
+            cli.search.coloring_depth = parse_int(arg, value());
+        } else if (arg == "--top-k") {
+            cli.top_k = parse_int(arg, value());
+        } else if (arg == "--memory-limit") {
+            cli.memory_limit_mb = parse_int(arg, value());
+            if (cli.memory_limit_mb == 0) usage_error("--memory-limit must be positive");
+        } else if (arg == "--output") {
+            cli.output = value();
+            cli.mode = CliqueWriter::Mode::Text;
+        } else if (arg == "--binary") {
+            cli.output = value();
+            cli.mode = CliqueWriter::Mode::Binary;
+        } else if (arg == "--count") {
+            cli.mode = CliqueWriter::Mode::Count;
+        } else if (arg == "--stats") {
+            cli.stats = true;
+        } else if (arg == "--edge-support") {
+            cli.edge_support = true;
+        } else if (arg == "--sorted") {
+            cli.sorted = true;
+        } else if (arg == "--twins") {
+            cli.twins = true;
+        } else if (arg == "--families") {
+            cli.twins = cli.families = true;
+        } else if (!arg.empty() && arg[0] == '-' && arg != "-") {
+            usage_error("unknown option: " + arg);
+        } else if (cli.input.empty()) {
+            cli.input = arg;
+        } else {
+            usage_error("more than one input file");
+        }
+    }
+    if (cli.input.empty()) usage_error("no input file");
+    if (cli.memory_limit_mb > 0 && cli.twins) usage_error("--memory-limit does not support --twins");
+    if (cli.sorted && (cli.twins || cli.top_k > 0)) usage_error("--sorted does not support --twins or --top-k");
+    if (cli.edge_support && (cli.sorted || cli.twins || cli.top_k > 0)) {
+        usage_error("--edge-support does not support --sorted, --twins or --top-k");
+    }
+    if (cli.engine != "matrix" &&
+        (cli.pivot != "tomita" || cli.search.ordering != VertexOrdering::VertexId || cli.search.coloring_depth >= 0 ||
+         cli.top_k > 0 || cli.twins || cli.edge_support)) {
+        usage_error("--engine " + cli.engine + " supports only the size bounds and --threads");
+    }
+    if (cli.families && (cli.mode == CliqueWriter::Mode::Binary || cli.search.min_size > 1)) {
+        usage_error("--families cannot be combined with --binary or --min-size");
+    }
+    if (cli.twins && (cli.top_k > 0 || cli.search.max_size != numeric_limits<int>::max() ||
+                      cli.search.coloring_depth >= 0)) {
+        usage_error("--twins cannot be combined with --top-k, --max-size or --coloring-depth");
+    }
+    if (!cli.format_given && cli.input != "-") cli.format = graph_format_for_path(cli.input);
+    return cli;
+}
+
+// Calls 'run' with a default-constructed instance of the pivot policy named 'name'.
+template <typename Run>
+void with_pivot_policy(const string& name, Run&& run) {
+    if (name == "tomita") run(TomitaPivot());
+    else if (name == "maxdegree") run(MaxDegreePivot());
+    else if (name == "first") run(FirstVertexPivot());
+    else if (name == "random") run(RandomPivot());
+    else if (name == "naude") run(NaudePivot());
+    else if (name == "none") run(NoPivot());
+    else usage_error("unknown pivot policy: " + name);
+}
+
+// Runs the search on a Graph; returns the number of edges.
+long long run_matrix_engine(const GraphEdges& graph_edges, const CliOptions& cli, CliqueWriter& writer,
+                            CliqueSearchStats& stats) {
+    Graph g = make_graph(graph_edges);
+    with_pivot_policy(cli.pivot, [&](auto pivot) {
+        using Pivot = decltype(pivot);
+        if (cli.twins) {
+            TwinReduction reduction(g);
+            size_t min_size = cli.search.min_size;
+            if (cli.families) {
+                reduction.for_each_clique_family<Pivot>(
+                    [&](const CliqueFamily& family) { writer.write_family(family); }, stats, pivot);
+            } else {
+                reduction.for_each_max_clique<Pivot>(
+                    [&](const set<int>& clique) {
+                        if (clique.size() >= min_size) writer.write(clique);
+                    },
+                    stats, pivot);
+            }
+            if (cli.stats) {
+                cerr << "reduced vertices: " << reduction.quotient.num_vertices << "\n";
+            }
+        } else if (cli.top_k > 0) {
+            for (const auto& clique : g.find_top_k_cliques<Pivot>(cli.top_k, cli.search, stats, pivot)) {
+                writer.write(clique);
+            }
+        } else {
+            CliqueCallback emit = [&](const set<int>& clique) { writer.write(clique); };
+            if (cli.sorted) {
+                for_each_max_clique_sorted<Pivot>(g, emit, cli.threads, cli.search, stats, pivot);
+            } else if (cli.edge_support) {
+                EdgeSupport support(g, cli.threads);
+                support.for_each_max_clique<Pivot>(emit, cli.threads, cli.search, stats, pivot);
+                if (cli.stats) {
+                    cerr << "triangles: " << support.num_triangles() << "\n";
+                }
+            } else {
+                g.for_each_max_clique_parallel<Pivot>(emit, cli.threads, cli.search, stats, pivot);
+            }
+        }
+    });
+    long long edges = 0;
+    for (const auto& row : g.adj_bits) {
+        for (uint64_t word : row) edges += __builtin_popcountll(word);
+    }
+    return edges / 2;
+}
+
+// Runs the search on one of the engines for sparse graphs; returns the number of edges.
+template <typename Engine>
+long long run_sparse_engine(const GraphEdges& graph_edges, const CliOptions& cli, CliqueWriter& writer,
+                            CliqueSearchStats& stats) {
+    Engine engine(graph_edges.num_vertices, graph_edges.edges);
+    if (cli.sorted) {
+        // These engines visit the vertices in degeneracy order, so their output is sorted externally.
+        // The buffer is charged to the search's budget, and spills well before it reaches the limit.
+        size_t buffer_bytes = min(size_t(64) << 20, cli.search.memory->limit() / 4);
+        CliqueStore store(buffer_bytes, "", cli.search.memory);
+        engine.for_each_max_clique(store.collector(), cli.search, stats, cli.threads);
+        store.for_each([&](const vector<int>& clique) { writer.write(set<int>(clique.begin(), clique.end())); });
+    } else {
+        CliqueCallback emit = [&](const set<int>& clique) { writer.write(clique); };
+        engine.for_each_max_clique(emit, cli.search, stats, cli.threads);
+    }
+    long long edges = 0;
+    for (int v = 0; v < engine.num_vertices; ++v) {
+        edges += engine.degree(v);
+    }
+    if (cli.stats) {
+        cerr << "degeneracy: " << engine.degeneracy() << "\n"
+             << "adjacency memory: " << engine.memory_bytes() << " bytes\n";
+    }
+    return edges / 2;
+}
+
+int main(int argc, char** argv) {
+    CliOptions cli = parse_arguments(argc, argv);
+    try {
+        auto load_start = chrono::steady_clock::now();
+        GraphEdges graph_edges =
+            cli.input == "-" ? read_graph_edges(cin, cli.format) : read_graph_edges_file(cli.input, cli.format);
+        double load_seconds = chrono::duration<double>(chrono::steady_clock::now() - load_start).count();
+
+        FILE* out = stdout;
+        if (!cli.output.empty()) {
+            out = fopen(cli.output.c_str(), cli.mode == CliqueWriter::Mode::Binary ? "wb" : "w");
+            if (!out) throw runtime_error("cannot open " + cli.output);
+        }
+        CliqueWriter writer(cli.mode, out);
+        MemoryBudget budget(cli.memory_limit_mb > 0 ? static_cast<size_t>(cli.memory_limit_mb) << 20 : SIZE_MAX);
+        cli.search.memory = &budget;
+        CliqueSearchStats stats;
+        auto search_start = chrono::steady_clock::now();
+        long long edges;
+        if (cli.engine == "roaring") {
+            edges = run_sparse_engine<SparseCliqueEngine<RoaringBitmap>>(graph_edges, cli, writer, stats);
+        } else if (cli.engine == "sorted") {
+            edges = run_sparse_engine<SparseCliqueEngine<SortedVertexSet>>(graph_edges, cli, writer, stats);
+        } else if (cli.engine == "partition") {
+            edges = run_sparse_engine<PartitionCliqueEngine>(graph_edges, cli, writer, stats);
+        } else {
+            edges = run_matrix_engine(graph_edges, cli, writer, stats);
+        }
+        writer.close();
+        double search_seconds = chrono::duration<double>(chrono::steady_clock::now() - search_start).count();
+        if (cli.mode == CliqueWriter::Mode::Count) {
+            cout << writer.written() << endl;
+        }
+
+        if (cli.stats) {
+            cerr << "vertices: " << graph_edges.num_vertices << "\n"
+                 << "edges: " << edges << "\n"
+                 << "cliques: " << writer.written() << "\n"
+                 << "nodes: " << stats.nodes << "\n"
+                 << "pruned: " << stats.pruned << "\n"
+                 << "max depth: " << stats.max_depth << "\n"
+                 << "peak search memory: " << stats.memory_peak << " bytes\n"
+                 << "load time: " << load_seconds << " s\n"
+                 << "search time: " << search_seconds << " s\n"
+                 << "cliques/s: " << (search_seconds > 0 ? writer.written() / search_seconds : 0) << endl;
+        }
+        if (stats.memory_exceeded) {
+            cerr << "bk_cli: memory limit of " << cli.memory_limit_mb << " MB exceeded; the output is partial" << endl;
+            return 3;
+        }
+    } catch (const exception& e) {
+        cerr << "bk_cli: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
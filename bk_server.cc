@@ -0,0 +1,412 @@
+#include <iostream>
+#include <vector>
+#include <set>
+#include <map>
+#include <list>
+#include <unordered_map>
+#include <string>
+#include <sstream>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "bron_kerbosch.h"
+#include "clique_cache.h"
+#include "graph_io.h"
+
+using namespace std;
+
+static const char* const usage_text =
+    "usage: bk_server --socket PATH [options] [name=graph-file ...]\n"
+    "\n"
+    "Keeps graphs in memory and answers clique queries over a Unix domain socket.\n"
+    "\n"
+    "options:\n"
+    "  --socket PATH        socket to listen on (required)\n"
+    "  --cache-entries N    number of query results kept in the LRU cache (default: 4096, 0 disables)\n"
+    "  --subgraph-cache-mb N  memory for neighborhood results shared by identical neighborhoods\n"
+    "                       (default: 256, 0 disables)\n"
+    "  --threads N          worker threads for whole-graph counts, 0 for all cores (default: 1)\n"
+    "\n"
+    "protocol: one request per line, answered by \"OK <n>\" and n result lines, or \"ERR <message>\".\n"
+    "  LOAD <name> <file> [format]   load a graph (replacing one of the same name); OK 0\n"
+    "  DROP <name>                   unload a graph\n"
+    "  LIST                          one line per graph: name, vertices, edges\n"
+    "  CLIQUES <name> <v> [min]      the maximal cliques containing v with at least min vertices\n"
+    "  MAX <name> <v>                a maximum clique containing v\n"
+    "  COUNT <name> [v]              number of maximal cliques (containing v); the count is in <n>\n"
+    "  TOPK <name> <k> [v]           the k largest maximal cliques (containing v)\n"
+    "  STATS                         server counters\n"
+    "  QUIT                          close the connection\n"
+    "A line longer than 8192 bytes is answered by \"ERR line too long\" and closes the connection.\n";
+
+static atomic<bool> stop_requested{false};
+
+// A graph kept resident by the server. Queries only read it, so any number of connections may
+// search it at once; LOAD of the same name swaps in a new instance instead of modifying this one.
+struct LoadedGraph {
+    Graph graph;
+    // Unique per load, so cached results of a replaced graph are never returned for the new one.
+    uint64_t generation;
+    long long edges;
+};
+
+// Least-recently-used cache of formatted query responses.
+class ResultCache {
+public:
+    explicit ResultCache(size_t capacity) : capacity(capacity) {}
+
+    bool lookup(const string& key, string& response) {
+        lock_guard<mutex> lock(cache_mutex);
+        auto it = index.find(key);
+        if (it == index.end()) return false;
+        entries.splice(entries.begin(), entries, it->second);
+        response = it->second->second;
+        return true;
+    }
+
+    void store(const string& key, const string& response) {
+        if (capacity == 0) return;
+        lock_guard<mutex> lock(cache_mutex);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            entries.erase(it->second);
+            index.erase(it);
+        }
+        entries.emplace_front(key, response);
+        index[key] = entries.begin();
+        if (entries.size() > capacity) {
+            index.erase(entries.back().first);
+            entries.pop_back();
+        }
+    }
+
+    size_t size() {
+        lock_guard<mutex> lock(cache_mutex);
+        return entries.size();
+    }
+
+private:
+    size_t capacity;
+    mutex cache_mutex;
+    list<pair<string, string>> entries;
+    unordered_map<string, list<pair<string, string>>::iterator> index;
+};
+
+class CliqueServer {
+public:
+    CliqueServer(size_t cache_entries, size_t subgraph_cache_bytes, int threads)
+        : cache(cache_entries), subgraph_cache(subgraph_cache_bytes), threads(threads) {}
+
+    // Loads a graph file under 'name'; throws std::runtime_error if it cannot be read.
+    shared_ptr<LoadedGraph> load(const string& name, const string& path, GraphFormat format) {
+        auto loaded = make_shared<LoadedGraph>(LoadedGraph{read_graph_file(path, format), next_generation++, 0});
+        for (const auto& row : loaded->graph.adj_bits) {
+            for (uint64_t word : row) loaded->edges += __builtin_popcountll(word);
+        }
+        loaded->edges /= 2;
+        unique_lock<shared_mutex> lock(graphs_mutex);
+        graphs[name] = loaded;
+        return loaded;
+    }
+
+    // Answers one request line; returns false if the connection should be closed.
+    bool handle(const string& line, string& response) {
+        istringstream in(line);
+        string command;
+        in >> command;
+        vector<string> args;
+        for (string arg; in >> arg;) args.push_back(arg);
+        queries++;
+        try {
+            if (command == "QUIT") {
+                return false;
+            } else if (command == "LOAD") {
+                expect_args(args, 2, 3);
+                GraphFormat format = graph_format_for_path(args[1]);
+                if (args.size() == 3 && !parse_graph_format(args[2], format)) {
+                    throw runtime_error("unknown format: " + args[2]);
+                }
+                load(args[0], args[1], format);
+                response = "OK 0\n";
+            } else if (command == "DROP") {
+                expect_args(args, 1, 1);
+                unique_lock<shared_mutex> lock(graphs_mutex);
+                if (!graphs.erase(args[0])) throw runtime_error("no graph named " + args[0]);
+                response = "OK 0\n";
+            } else if (command == "LIST") {
+                expect_args(args, 0, 0);
+                shared_lock<shared_mutex> lock(graphs_mutex);
+                response = "OK " + to_string(graphs.size()) + "\n";
+                for (const auto& entry : graphs) {
+                    response += entry.first + " " + to_string(entry.second->graph.num_vertices) + " " +
+                                to_string(entry.second->edges) + "\n";
+                }
+            } else if (command == "STATS") {
+                expect_args(args, 0, 0);
+                CliqueCacheStats subgraph_stats = subgraph_cache.stats();
+                response = "OK 7\nqueries " + to_string(queries.load()) + "\ncache_hits " +
+                           to_string(cache_hits.load()) + "\ncache_entries " + to_string(cache.size()) +
+                           "\nsubgraph_cache_hits " + to_string(subgraph_stats.hits) +
+                           "\nsubgraph_cache_entries " + to_string(subgraph_stats.entries) +
+                           "\nsubgraph_cache_bytes " + to_string(subgraph_stats.bytes) +
+                           "\nconnections " + to_string(connections.load()) + "\n";
+            } else if (command == "CLIQUES" || command == "MAX" || command == "COUNT" || command == "TOPK") {
+                answer_query(command, args, response);
+            } else {
+                throw runtime_error("unknown command: " + command);
+            }
+        } catch (const exception& e) {
+            response = string("ERR ") + e.what() + "\n";
+        }
+        return true;
+    }
+
+    atomic<long long> connections{0};
+
+private:
+    ResultCache cache;
+    // Keyed by the content of the neighborhood, so it is shared by all graphs and survives reloads.
+    CliqueCache subgraph_cache;
+    int threads;
+    shared_mutex graphs_mutex;
+    map<string, shared_ptr<LoadedGraph>> graphs;
+    atomic<uint64_t> next_generation{1};
+    atomic<long long> queries{0};
+    atomic<long long> cache_hits{0};
+
+    static void expect_args(const vector<string>& args, size_t min_count, size_t max_count) {
+        if (args.size() < min_count || args.size() > max_count) throw runtime_error("wrong number of arguments");
+    }
+
+    static int parse_int(const string& text) {
+        char* end;
+        long value = strtol(text.c_str(), &end, 10);
+        if (text.empty() || *end != '\0' || value < 0 || value > numeric_limits<int>::max()) {
+            throw runtime_error("invalid number: " + text);
+        }
+        return static_cast<int>(value);
+    }
+
+    shared_ptr<LoadedGraph> find_graph(const string& name) {
+        shared_lock<shared_mutex> lock(graphs_mutex);
+        auto it = graphs.find(name);
+        if (it == graphs.end()) throw runtime_error("no graph named " + name);
+        return it->second;
+    }
+
+    static void append_cliques(string& response, const vector<set<int>>& cliques) {
+        response = "OK " + to_string(cliques.size()) + "\n";
+        for (const auto& clique : cliques) {
+            const char* separator = "";
+            for (int v : clique) {
+                response += separator + to_string(v);
+                separator = " ";
+            }
+            response += '\n';
+        }
+    }
+
+    void answer_query(const string& command, const vector<string>& args, string& response) {
+        if (command == "MAX") {
+            expect_args(args, 2, 2);
+        } else {
+            expect_args(args, 1, 3);
+        }
+        shared_ptr<LoadedGraph> loaded = find_graph(args[0]);
+        Graph& g = loaded->graph;
+        string key = to_string(loaded->generation) + " " + command;
+        for (size_t i = 1; i < args.size(); ++i) key += " " + args[i];
+        if (cache.lookup(key, response)) {
+            cache_hits++;
+            return;
+        }
+
+        auto vertex = [&](const string& text) {
+            int v = parse_int(text);
+            if (v >= g.num_vertices) throw runtime_error("vertex out of range: " + text);
+            return v;
+        };
+        CliqueSearchOptions options;
+        CliqueSearchStats stats;
+        if (command == "CLIQUES") {
+            if (args.size() < 2) throw runtime_error("wrong number of arguments");
+            int v = vertex(args[1]);
+            size_t min_size = args.size() == 3 ? parse_int(args[2]) : 0;
+            vector<set<int>> cliques = subgraph_cache.max_cliques_containing(g, v);
+            cliques.erase(remove_if(cliques.begin(), cliques.end(),
+                                    [&](const set<int>& clique) { return clique.size() < min_size; }),
+                          cliques.end());
+            append_cliques(response, cliques);
+        } else if (command == "MAX") {
+            append_cliques(response, g.find_top_k_cliques_containing<TomitaPivot>(vertex(args[1]), 1, options, stats));
+        } else if (command == "COUNT") {
+            if (args.size() > 2) throw runtime_error("wrong number of arguments");
+            if (args.size() == 2) {
+                response = "OK " + to_string(subgraph_cache.count_max_cliques_containing(g, vertex(args[1]))) + "\n";
+            } else {
+                CliqueCallback ignore = [](const set<int>&) {};
+                g.for_each_max_clique_parallel<TomitaPivot>(ignore, threads, options, stats);
+                response = "OK " + to_string(stats.cliques) + "\n";
+            }
+        } else {
+            if (args.size() < 2) throw runtime_error("wrong number of arguments");
+            int k = parse_int(args[1]);
+            append_cliques(response, args.size() == 3
+                                         ? g.find_top_k_cliques_containing<TomitaPivot>(vertex(args[2]), k, options, stats)
+                                         : g.find_top_k_cliques<TomitaPivot>(k, options, stats));
+        }
+        cache.store(key, response);
+    }
+};
+
+static bool send_all(int fd, const string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// The longest request line accepted. Longer ones, with or without a newline yet, get an error and the
+// connection is closed, so a client cannot make the server buffer without bound.
+static const size_t max_line_bytes = 8192;
+
+// Serves one client until it sends QUIT, disconnects or sends a line longer than max_line_bytes.
+static void serve_connection(int fd, CliqueServer& server) {
+    server.connections++;
+    string pending;
+    char chunk[4096];
+    bool open = true;
+    while (open) {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        pending.append(chunk, static_cast<size_t>(n));
+        size_t newline;
+        while (open && (newline = pending.find('\n')) != string::npos) {
+            if (newline > max_line_bytes) break;
+            string line = pending.substr(0, newline);
+            pending.erase(0, newline + 1);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+            string response;
+            open = server.handle(line, response) && send_all(fd, response);
+        }
+        if (open && min(pending.find('\n'), pending.size()) > max_line_bytes) {
+            // Discard the rest of the request until the client closes, since closing a socket with
+            // unread data resets the connection and may lose the reply.
+            send_all(fd, "ERR line too long\n");
+            shutdown(fd, SHUT_WR);
+            for (;;) {
+                n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n == 0 || (n < 0 && errno != EINTR)) break;
+            }
+            open = false;
+        }
+    }
+    close(fd);
+    server.connections--;
+}
+
+[[noreturn]] static void usage_error(const string& message) {
+    cerr << "bk_server: " << message << "\n\n" << usage_text;
+    exit(2);
+}
+
+static int parse_int(const string& flag, const char* value) {
+    char* end;
+    long parsed = strtol(value, &end, 10);
+    if (*value == '\0' || *end != '\0' || parsed < 0 || parsed > numeric_limits<int>::max()) {
+        usage_error("invalid value for " + flag + ": " + value);
+    }
+    return static_cast<int>(parsed);
+}
+
+int main(int argc, char** argv) {
+    string socket_path;
+    size_t cache_entries = 4096;
+    size_t subgraph_cache_mb = 256;
+    int threads = 1;
+    vector<pair<string, string>> initial_graphs;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        auto value = [&]() -> string {
+            if (i + 1 >= argc) usage_error("missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--help" || arg == "-h") {
+            cout << usage_text;
+            return 0;
+        } else if (arg == "--socket") {
+            socket_path = value();
+        } else if (arg == "--cache-entries") {
+            cache_entries = parse_int(arg, value().c_str());
+        } else if (arg == "--subgraph-cache-mb") {
+            subgraph_cache_mb = parse_int(arg, value().c_str());
+            if (subgraph_cache_mb > (SIZE_MAX >> 20)) usage_error("invalid value for " + arg + ": too large");
+        } else if (arg == "--threads") {
+            threads = parse_int(arg, value().c_str());
+            if (threads == 0) threads = max(1u, thread::hardware_concurrency());
+        } else if (arg.find('=') != string::npos && arg[0] != '-') {
+            initial_graphs.emplace_back(arg.substr(0, arg.find('=')), arg.substr(arg.find('=') + 1));
+        } else {
+            usage_error("unknown argument: " + arg);
+        }
+    }
+    if (socket_path.empty()) usage_error("--socket is required");
+
+    CliqueServer server(cache_entries, subgraph_cache_mb << 20, threads);
+    for (const auto& graph : initial_graphs) {
+        try {
+            auto loaded = server.load(graph.first, graph.second, graph_format_for_path(graph.second));
+            cerr << "bk_server: loaded " << graph.first << " (" << loaded->graph.num_vertices << " vertices, "
+                 << loaded->edges << " edges)" << endl;
+        } catch (const exception& e) {
+            cerr << "bk_server: " << graph.second << ": " << e.what() << endl;
+            return 1;
+        }
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) usage_error("socket path too long");
+    strncpy(address.sun_path, socket_path.c_str(), sizeof(address.sun_path) - 1);
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socket_path.c_str());
+    if (listen_fd < 0 || ::bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listen_fd, 64) < 0) {
+        cerr << "bk_server: cannot listen on " << socket_path << ": " << strerror(errno) << endl;
+        return 1;
+    }
+    signal(SIGINT, [](int) { stop_requested = true; });
+    signal(SIGTERM, [](int) { stop_requested = true; });
+    cerr << "bk_server: listening on " << socket_path << endl;
+
+    while (!stop_requested) {
+        pollfd listener{listen_fd, POLLIN, 0};
+        if (poll(&listener, 1, 200) <= 0) continue;
+        int client_fd = accept(listen_fd, nullptr, nullptr);
+        if (client_fd < 0) continue;
+        thread(serve_connection, client_fd, ref(server)).detach();
+    }
+    close(listen_fd);
+    unlink(socket_path.c_str());
+    // Connection threads are detached and may still be using the server, so skip its destructor.
+    exit(0);
+}
@@ -0,0 +1,2065 @@
+#include <iostream>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <cassert>
+#include <sstream>
+#include <random>
+#include <iterator>
+
+#include "bron_kerbosch.h"
+#include "graph_generators.h"
+#include "graph_io.h"
+#include "clique_cache.h"
+#include "twin_reduction.h"
+#include "roaring_bitmap.h"
+#include "sparse_engine.h"
+#include "sorted_vertex_set.h"
+#include "partition_engine.h"
+#include "clique_store.h"
+#include "sorted_output.h"
+#include "local_subgraph.h"
+#include "edge_support.h"
+
+using namespace std;
+
+void test_find_max_cliques() {
+    cout << "Running tests for find_max_cliques..." << endl;
+
+    // Helper lambda for comparing results
+    auto run_test = [](const string& test_name, Graph& g, vector<set<int>>& expected_cliques) {
+        cout << "--- Test Case: " << test_name << " ---" << endl;
+        vector<set<int>> actual_cliques = g.find_max_cliques();
+
+        sort(expected_cliques.begin(), expected_cliques.end());
+        sort(actual_cliques.begin(), actual_cliques.end());
+
+        assert(actual_cliques == expected_cliques);
+        cout << test_name << ": Passed!" << endl;
+    };
+
+    // Test Case 1: Empty Graph (0 vertices)
+    {
+        Graph g(0);
+        vector<set<int>> expected = {};
+        run_test("Empty Graph (0 Vertices)", g, expected);
+    }
+
+    // Test Case 2: 1 Vertex
+    {
+        Graph g(1);
+        vector<set<int>> expected = {{0}};
+        run_test("1 Vertex", g, expected);
+    }
+
+    // Test Case 3: 2 Vertices, No Edge
+    {
+        Graph g(2);
+        vector<set<int>> expected = {{0}, {1}};
+        run_test("2 Vertices, No Edge", g, expected);
+    }
+
+    // Test Case 4: 2 Vertices, 1 Edge
+    {
+        Graph g(2);
+        g.add_edge(0, 1);
+        vector<set<int>> expected = {{0, 1}};
+        run_test("2 Vertices, 1 Edge", g, expected);
+    }
+
+    // Test Case 5: Triangle (K3)
+    {
+        Graph g(3);
+        g.add_edge(0, 1);
+        g.add_edge(1, 2);
+        g.add_edge(2, 0);
+        vector<set<int>> expected = {{0, 1, 2}};
+        run_test("Triangle (K3)", g, expected);
+    }
+
+     // Test Case 6: Line Graph (3 vertices)
+     {
+        Graph g(3);
+        g.add_edge(0, 1);
+        g.add_edge(1, 2);
+        vector<set<int>> expected = {{0, 1}, {1, 2}};
+        run_test("Line Graph (3 Vertices)", g, expected);
+     }
+
+     // Test Case 7: Square Graph (C4)
+     {
+        Graph g(4);
+        g.add_edge(0, 1);
+        g.add_edge(1, 2);
+        g.add_edge(2, 3);
+        g.add_edge(3, 0);
+        vector<set<int>> expected = {{0, 1}, {1, 2}, {2, 3}, {0, 3}};
+        run_test("Square Graph (C4)", g, expected);
+     }
+
+    // Test Case 8: Complete Graph (K4)
+    {
+        Graph g(4);
+        g.add_edge(0, 1); g.add_edge(0, 2); g.add_edge(0, 3);
+        g.add_edge(1, 2); g.add_edge(1, 3);
+        g.add_edge(2, 3);
+        vector<set<int>> expected = {{0, 1, 2, 3}};
+        run_test("Complete Graph (K4)", g, expected);
+    }
+
+
+    // Test Case 9: Square with one diagonal (forms two triangles)
+    {
+        Graph g(4);
+        g.add_edge(0, 1); g.add_edge(1, 2); g.add_edge(2, 3); g.add_edge(3, 0);
+        g.add_edge(0, 2);
+        vector<set<int>> expected = {{0, 1, 2}, {0, 2, 3}};
+        run_test("Square + 1 Diagonal (0-2)", g, expected);
+    }
+
+    // Test Case 10: Disconnected Components (Two Triangles)
+    {
+        Graph g(6);
+        g.add_edge(0, 1); g.add_edge(1, 2); g.add_edge(2, 0);
+        g.add_edge(3, 4); g.add_edge(4, 5); g.add_edge(5, 3);
+        vector<set<int>> expected = {{0, 1, 2}, {3, 4, 5}};
+        run_test("Disconnected (2 Triangles)", g, expected);
+    }
+
+    // Test Case 11: Pentagon (C5)
+    {
+        Graph g(5);
+        g.add_edge(0, 1); g.add_edge(1, 2); g.add_edge(2, 3); g.add_edge(3, 4); g.add_edge(4, 0);
+        vector<set<int>> expected = {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {0, 4}};
+        run_test("Pentagon (C5)", g, expected);
+    }
+
+
+    // Test Case 12: House Graph (Square base + triangle roof)
+    {
+        Graph g(5);
+        g.add_edge(0, 1); g.add_edge(1, 2); g.add_edge(2, 3); g.add_edge(3, 0);
+        g.add_edge(0, 4); g.add_edge(1, 4);
+        vector<set<int>> expected = {{0, 1, 4}, {1, 2}, {2, 3}, {0, 3}};
+        run_test("House Graph", g, expected);
+    }
+
+    // Test Case 13: Bron-Kerbosch Example Graph (from Wikipedia/common examples)
+    {
+        Graph g(6);
+        g.add_edge(0, 1); g.add_edge(0, 4);
+        g.add_edge(1, 2); g.add_edge(1, 4);
+        g.add_edge(2, 3);
+        g.add_edge(3, 4); g.add_edge(3, 5);
+        // Expected Maximal Cliques: {0, 1, 4}, {1, 2}, {2, 3}, {3, 4}, {3, 5}
+        vector<set<int>> expected = {{0, 1, 4}, {1, 2}, {2, 3}, {3, 4}, {3, 5}};
+        run_test("Bron-Kerbosch Example", g, expected);
+    }
+
+    // Test Case 14: Graph with an isolated vertex
+    {
+        Graph g(4);
+        g.add_edge(0, 1); g.add_edge(1, 2); g.add_edge(0, 2);
+        vector<set<int>> expected = {{0, 1, 2}, {3}};
+        run_test("Triangle + Isolated Vertex", g, expected);
+    }
+
+     // Test Case 15: Complete Bipartite Graph K_{3,3} (should have only edges as max cliques)
+    {
+        Graph g(6);
+        for(int i = 0; i < 3; ++i) {
+            for(int j = 3; j < 6; ++j) {
+                g.add_edge(i, j);
+            }
+        }
+        vector<set<int>> expected = {
+            {0, 3}, {0, 4}, {0, 5},
+            {1, 3}, {1, 4}, {1, 5},
+            {2, 3}, {2, 4}, {2, 5}
+        };
+         run_test("Complete Bipartite K(3,3)", g, expected);
+    }
+
+
+    cout << "\nAll tests passed!" << endl;
+}
+
+bool is_clique(Graph& g, const set<int>& vertices) {
+    for (int u : vertices) {
+        for (int v : vertices) {
+            if (u != v && !g.adj_matrix[u][v]) return false;
+        }
+    }
+    return true;
+}
+
+void test_size_bounded_cliques() {
+    cout << "\nRunning tests for size-bounded find_max_cliques..." << endl;
+
+    auto run_test = [](const string& test_name, Graph& g, int min_size, int max_size,
+                       vector<set<int>> expected_cliques) {
+        cout << "--- Test Case: " << test_name << " ---" << endl;
+        vector<set<int>> actual_cliques = g.find_max_cliques(min_size, max_size);
+        sort(expected_cliques.begin(), expected_cliques.end());
+        sort(actual_cliques.begin(), actual_cliques.end());
+        assert(actual_cliques == expected_cliques);
+        cout << test_name << ": Passed!" << endl;
+    };
+
+    // Test Case 1: House Graph keeps only the roof triangle for min_size = 3
+    {
+        Graph g(5);
+        g.add_edge(0, 1); g.add_edge(1, 2); g.add_edge(2, 3); g.add_edge(3, 0);
+        g.add_edge(0, 4); g.add_edge(1, 4);
+        run_test("House Graph, [3, 5]", g, 3, 5, {{0, 1, 4}});
+        run_test("House Graph, [2, 3]", g, 2, 3, {{0, 1, 4}, {1, 2}, {2, 3}, {0, 3}});
+    }
+
+    // Test Case 2: K4 truncated at size 2 still reports pairs covering the clique
+    {
+        Graph g(5);
+        g.add_edge(0, 1); g.add_edge(0, 2); g.add_edge(0, 3);
+        g.add_edge(1, 2); g.add_edge(1, 3); g.add_edge(2, 3);
+        run_test("K4 + Isolated, [1, 4]", g, 1, 4, {{0, 1, 2, 3}, {4}});
+        run_test("K4 + Isolated, [5, 6]", g, 5, 6, {});
+        vector<set<int>> truncated = g.find_max_cliques(2, 3);
+        assert(!truncated.empty());
+        for (const auto& clique : truncated) {
+            assert(clique.size() == 3 && is_clique(g, clique));
+        }
+        cout << "K4 truncated at 3: Passed!" << endl;
+    }
+
+    // Test Case 3: Random graphs agree with filtering the unbounded enumeration
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        Graph g = make_random_graph(30, 0.4, seed);
+        vector<set<int>> all_cliques = g.find_max_cliques();
+        for (int min_size = 1; min_size <= 6; ++min_size) {
+            vector<set<int>> expected;
+            for (const auto& clique : all_cliques) {
+                if (static_cast<int>(clique.size()) >= min_size) expected.push_back(clique);
+            }
+            run_test("Random G(30, 0.4) seed " + to_string(seed) + ", min_size " + to_string(min_size),
+                     g, min_size, 30, expected);
+        }
+        // Every maximal clique larger than the cap contains a reported truncated clique.
+        vector<set<int>> truncated = g.find_max_cliques(1, 4);
+        for (const auto& clique : all_cliques) {
+            if (clique.size() <= 4) {
+                assert(find(truncated.begin(), truncated.end(), clique) != truncated.end());
+                continue;
+            }
+            bool covered = false;
+            for (const auto& small : truncated) {
+                covered = covered || (small.size() == 4 && includes(clique.begin(), clique.end(),
+                                                                     small.begin(), small.end()));
+            }
+            assert(covered);
+        }
+    }
+
+    // Test Case 4: The coloring bound never changes the result, whatever the recoloring depth
+    for (unsigned seed = 1; seed <= 4; ++seed) {
+        Graph g = make_random_graph(70, 0.5, seed);
+        for (int min_size = 4; min_size <= 8; min_size += 2) {
+            vector<set<int>> expected = g.find_max_cliques(min_size, 70);
+            sort(expected.begin(), expected.end());
+            for (int depth = 0; depth <= 3; ++depth) {
+                CliqueSearchOptions options;
+                options.min_size = min_size;
+                options.coloring_depth = depth;
+                vector<set<int>> actual = g.find_max_cliques(options);
+                sort(actual.begin(), actual.end());
+                assert(actual == expected);
+            }
+        }
+        cout << "Coloring bound, G(70, 0.5) seed " << seed << ": Passed!" << endl;
+    }
+
+    cout << "\nAll size-bounded clique tests passed!" << endl;
+}
+
+void test_vertex_orderings() {
+    cout << "\nRunning tests for vertex orderings..." << endl;
+
+    const VertexOrdering orderings[] = {VertexOrdering::VertexId, VertexOrdering::DegreeDescending,
+                                        VertexOrdering::DegreeAscending, VertexOrdering::CoreAscending,
+                                        VertexOrdering::ColorDescending};
+
+    // Test Case 1: Every ordering finds the same cliques, and the counters agree with the output
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Graph g = make_random_graph(40, 0.3 * seed, seed);
+        vector<set<int>> expected = g.find_max_cliques();
+        sort(expected.begin(), expected.end());
+        for (VertexOrdering ordering : orderings) {
+            CliqueSearchOptions options;
+            options.ordering = ordering;
+            CliqueSearchStats stats;
+            vector<set<int>> actual = g.find_max_cliques(options, stats);
+            assert(stats.cliques == static_cast<long long>(actual.size()));
+            assert(stats.nodes >= stats.cliques);
+            sort(actual.begin(), actual.end());
+            assert(actual == expected);
+        }
+        cout << "Orderings agree, G(40, " << 0.3 * seed << ") seed " << seed << ": Passed!" << endl;
+    }
+
+    // Test Case 2: Moon-Moser graph reports all 3^k cliques
+    {
+        Graph g = make_moon_moser_graph(4);
+        CliqueSearchStats stats;
+        g.find_max_cliques(CliqueSearchOptions(), stats);
+        assert(stats.cliques == 81 && stats.max_depth == 4);
+        cout << "Moon-Moser (k = 4) counters: Passed!" << endl;
+    }
+
+    // Test Case 3: ColorDescending branches the same way whether it reuses the coloring of the
+    // coloring bound or colors P itself; the bound only cuts subtrees without output
+    {
+        Graph g = make_random_graph(50, 0.4, 9);
+        CliqueSearchOptions options;
+        options.ordering = VertexOrdering::ColorDescending;
+        options.min_size = 4;
+        vector<set<int>> expected = g.find_max_cliques(options);
+        for (int depth : {0, 2, 100}) {
+            options.coloring_depth = depth;
+            assert(g.find_max_cliques(options) == expected);
+        }
+        cout << "ColorDescending with the coloring bound: Passed!" << endl;
+    }
+
+    cout << "\nAll vertex ordering tests passed!" << endl;
+}
+
+void test_pivot_policies() {
+    cout << "\nRunning tests for pivot policies..." << endl;
+
+    auto check_policy = [](const string& test_name, Graph& g, const vector<set<int>>& expected, auto pivot) {
+        CliqueSearchStats stats;
+        vector<set<int>> actual = g.find_max_cliques_with_pivot(CliqueSearchOptions(), stats, pivot);
+        sort(actual.begin(), actual.end());
+        assert(actual == expected);
+        cout << test_name << ": Passed! (" << stats.nodes << " nodes)" << endl;
+        return stats.nodes;
+    };
+
+    // Test Case 1: Every policy reports the same cliques on random and structured graphs
+    vector<pair<string, Graph>> graphs = {{"G(35, 0.5)", make_random_graph(35, 0.5, 3)},
+                                          {"G(50, 0.2)", make_random_graph(50, 0.2, 4)},
+                                          {"Moon-Moser k = 4", make_moon_moser_graph(4)}};
+    for (auto& entry : graphs) {
+        Graph& g = entry.second;
+        vector<set<int>> expected = g.find_max_cliques();
+        sort(expected.begin(), expected.end());
+        long long tomita = check_policy(entry.first + ", Tomita", g, expected, TomitaPivot());
+        check_policy(entry.first + ", first vertex", g, expected, FirstVertexPivot());
+        check_policy(entry.first + ", max degree", g, expected, MaxDegreePivot());
+        check_policy(entry.first + ", random", g, expected, RandomPivot(7));
+        check_policy(entry.first + ", Naude sampling", g, expected, NaudePivot(4, 7));
+        long long none = check_policy(entry.first + ", no pivot", g, expected, NoPivot());
+        assert(tomita <= none);
+    }
+
+    // Test Case 2: Size bounds still apply with a custom pivot
+    {
+        Graph g(5);
+        g.add_edge(0, 1); g.add_edge(1, 2); g.add_edge(2, 3); g.add_edge(3, 0);
+        g.add_edge(0, 4); g.add_edge(1, 4);
+        CliqueSearchOptions options;
+        options.min_size = 3;
+        CliqueSearchStats stats;
+        vector<set<int>> actual = g.find_max_cliques_with_pivot<TomitaPivot>(options, stats);
+        assert(actual == vector<set<int>>({{0, 1, 4}}));
+        cout << "House Graph, Tomita, min_size 3: Passed!" << endl;
+    }
+
+    cout << "\nAll pivot policy tests passed!" << endl;
+}
+
+void test_clique_count_estimate() {
+    cout << "\nRunning tests for estimate_max_cliques..." << endl;
+
+    // Test Case 1: Every path of the Moon-Moser search tree looks the same, so the estimate is exact
+    {
+        Graph g = make_moon_moser_graph(5);
+        CliqueSearchStats stats;
+        g.find_max_cliques(CliqueSearchOptions(), stats);
+        CliqueCountEstimate estimate = g.estimate_max_cliques(50);
+        assert(estimate.cliques == 243 && estimate.cliques_error == 0);
+        assert(estimate.tree_nodes == stats.nodes && estimate.tree_nodes_error == 0);
+        cout << "Moon-Moser (k = 5) exact estimate: Passed!" << endl;
+    }
+
+    // Test Case 2: Estimates on random graphs land near the true counts
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Graph g = make_random_graph(60, 0.4, seed);
+        CliqueSearchStats stats;
+        g.find_max_cliques(CliqueSearchOptions(), stats);
+        CliqueCountEstimate estimate = g.estimate_max_cliques<TomitaPivot>(4000, seed);
+        CliqueSearchStats tomita_stats;
+        g.find_max_cliques_with_pivot<TomitaPivot>(CliqueSearchOptions(), tomita_stats);
+        cout << "G(60, 0.4) seed " << seed << ": " << stats.cliques << " cliques, estimated "
+             << estimate.cliques << " +- " << estimate.cliques_error << endl;
+        assert(estimate.cliques > 0.7 * stats.cliques && estimate.cliques < 1.3 * stats.cliques);
+        assert(estimate.tree_nodes > 0.7 * tomita_stats.nodes && estimate.tree_nodes < 1.3 * tomita_stats.nodes);
+        assert(estimate.seconds > 0 && estimate.samples == 4000);
+    }
+
+    // Test Case 3: Empty graph
+    {
+        Graph g(0);
+        CliqueCountEstimate estimate = g.estimate_max_cliques(10);
+        assert(estimate.cliques == 0 && estimate.tree_nodes == 0);
+        cout << "Empty Graph estimate: Passed!" << endl;
+    }
+
+    cout << "\nAll clique count estimate tests passed!" << endl;
+}
+
+void test_progress_reporting() {
+    cout << "\nRunning tests for progress reporting..." << endl;
+
+    // Test Case 1: Periodic updates are monotone and the final one accounts for the whole search
+    {
+        Graph g = make_moon_moser_graph(8);
+        vector<CliqueSearchProgress> updates;
+        mutex updates_mutex;
+        ProgressMonitor monitor([&](const CliqueSearchProgress& progress) {
+            lock_guard<mutex> lock(updates_mutex);
+            updates.push_back(progress);
+        }, chrono::milliseconds(1));
+        CliqueSearchOptions options;
+        options.progress = &monitor;
+        CliqueSearchStats stats;
+        vector<set<int>> cliques = g.find_max_cliques(options, stats);
+        assert(cliques.size() == 6561);
+        assert(!updates.empty() && updates.back().finished);
+        const CliqueSearchProgress& last = updates.back();
+        assert(last.top_level_total == 3 && last.top_level_done == 3);
+        assert(last.cliques == 6561 && last.nodes == stats.nodes && last.eta_seconds == 0);
+        for (size_t i = 1; i < updates.size(); ++i) {
+            assert(updates[i].nodes >= updates[i - 1].nodes);
+            assert(updates[i].top_level_done >= updates[i - 1].top_level_done);
+        }
+        cout << "Moon-Moser (k = 8), " << updates.size() << " updates: Passed!" << endl;
+    }
+
+    // Test Case 2: A search pruned at the root still delivers a final update
+    {
+        Graph g = make_random_graph(20, 0.2, 1);
+        int calls = 0;
+        ProgressMonitor monitor([&](const CliqueSearchProgress& progress) {
+            calls++;
+            assert(progress.finished && progress.top_level_total == 0 && progress.nodes == 1);
+        });
+        CliqueSearchOptions options;
+        options.min_size = 6;
+        options.progress = &monitor;
+        assert(g.find_max_cliques(options).empty());
+        assert(calls == 1);
+        cout << "Pruned search progress: Passed!" << endl;
+    }
+
+    cout << "\nAll progress reporting tests passed!" << endl;
+}
+
+void test_phase_profiler() {
+    cout << "\nRunning tests for the phase profiler..." << endl;
+
+    // Test Case 1: Manually recorded events show up in the totals and the Chrome trace
+    {
+        PhaseProfiler profiler(2);
+        profiler.record(SearchPhase::Pivot, 100, 150);
+        profiler.record(SearchPhase::Pivot, 200, 230);
+        profiler.record(SearchPhase::Output, 300, 301);
+        assert(profiler.phase_ticks(SearchPhase::Pivot) == 80 && profiler.phase_calls(SearchPhase::Pivot) == 2);
+        assert(profiler.phase_calls(SearchPhase::Output) == 1);
+        ostringstream trace;
+        profiler.write_chrome_trace(trace);
+        string json = trace.str();
+        assert(json.find("\"traceEvents\":[") != string::npos);
+        assert(json.find("\"name\":\"output\"") == string::npos);  // Beyond max_trace_events.
+        assert(json.find("\"output_calls\":1") != string::npos);
+        cout << "Manual events and trace: Passed!" << endl;
+    }
+
+    // Test Case 2: The search is only instrumented in -DBK_PROFILE builds
+    {
+        Graph g = make_random_graph(40, 0.5, 2);
+        PhaseProfiler profiler;
+        CliqueSearchOptions options;
+        options.profiler = &profiler;
+        CliqueSearchStats stats;
+        g.find_max_cliques(options, stats);
+#ifdef BK_PROFILE
+        assert(profiler.phase_calls(SearchPhase::Output) == stats.cliques);
+        assert(profiler.phase_calls(SearchPhase::Intersection) == stats.nodes - 1);
+#else
+        assert(profiler.phase_calls(SearchPhase::Output) == 0);
+#endif
+        cout << "Search instrumentation: Passed!" << endl;
+    }
+
+    // Test Case 3: Worker profiles are merged, each on its own trace thread
+    {
+        PhaseProfiler profiler(3), worker;
+        profiler.record(SearchPhase::Pivot, 100, 150);
+        worker.record(SearchPhase::Pivot, 200, 210);
+        worker.record(SearchPhase::Output, 300, 301);
+        worker.record(SearchPhase::Output, 400, 402);
+        profiler.merge(worker, 2);
+        assert(profiler.phase_ticks(SearchPhase::Pivot) == 60 && profiler.phase_calls(SearchPhase::Output) == 2);
+        ostringstream trace;
+        profiler.write_chrome_trace(trace);
+        string json = trace.str();
+        assert(json.find("\"tid\":1") != string::npos && json.find("\"tid\":2") != string::npos);
+        assert(json.find("\"output_calls\":2") != string::npos);
+
+        Graph g = make_random_graph(60, 0.5, 3);
+        for (bool deterministic : {false, true}) {
+            PhaseProfiler shared;
+            CliqueSearchOptions options;
+            options.profiler = &shared;
+            options.deterministic = deterministic;
+            CliqueSearchStats stats;
+            g.for_each_max_clique_parallel<TomitaPivot>([](const set<int>&) {}, 3, options, stats);
+#ifdef BK_PROFILE
+            assert(shared.phase_calls(SearchPhase::Output) == stats.cliques);
+#else
+            assert(shared.phase_calls(SearchPhase::Output) == 0);
+#endif
+        }
+        cout << "Parallel workers: Passed!" << endl;
+    }
+
+    cout << "\nAll phase profiler tests passed!" << endl;
+}
+
+void test_streaming_and_parallel() {
+    cout << "\nRunning tests for streaming, parallel and top-k enumeration..." << endl;
+
+    // Test Case 1: Streaming and parallel enumeration report the same cliques as find_max_cliques
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Graph g = make_random_graph(60, 0.4, seed);
+        vector<set<int>> expected = g.find_max_cliques();
+        sort(expected.begin(), expected.end());
+        for (int threads : {1, 2, 4}) {
+            vector<set<int>> actual;
+            CliqueSearchStats stats;
+            g.for_each_max_clique_parallel([&](const set<int>& clique) { actual.push_back(clique); }, threads,
+                                           CliqueSearchOptions(), stats, TomitaPivot());
+            assert(stats.cliques == static_cast<long long>(actual.size()));
+            sort(actual.begin(), actual.end());
+            assert(actual == expected);
+        }
+        cout << "Parallel enumeration, G(60, 0.4) seed " << seed << ": Passed!" << endl;
+    }
+
+    // Test Case 2: Parallel enumeration honours the size bounds
+    {
+        Graph g = make_random_graph(50, 0.5, 9);
+        CliqueSearchOptions options;
+        options.min_size = 5;
+        options.coloring_depth = 1;
+        vector<set<int>> expected = g.find_max_cliques(options);
+        sort(expected.begin(), expected.end());
+        vector<set<int>> actual;
+        CliqueSearchStats stats;
+        g.for_each_max_clique_parallel([&](const set<int>& clique) { actual.push_back(clique); }, 3, options, stats);
+        sort(actual.begin(), actual.end());
+        assert(actual == expected);
+        cout << "Parallel enumeration, min_size 5: Passed!" << endl;
+    }
+
+    // Test Case 3: An exception thrown by the callback reaches the caller
+    {
+        Graph g = make_random_graph(60, 0.4, 4);
+        CliqueSearchStats stats;
+        bool caught = false;
+        try {
+            g.for_each_max_clique_parallel([](const set<int>&) { throw runtime_error("write failed"); }, 3,
+                                           CliqueSearchOptions(), stats);
+        } catch (const runtime_error& e) {
+            caught = string(e.what()) == "write failed";
+        }
+        assert(caught);
+        cout << "Parallel enumeration, throwing callback: Passed!" << endl;
+    }
+
+    // Test Case 4: Top-k returns the k largest maximal cliques
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Graph g = make_random_graph(60, 0.5, seed);
+        vector<set<int>> all_cliques = g.find_max_cliques();
+        sort(all_cliques.begin(), all_cliques.end(),
+             [](const set<int>& a, const set<int>& b) { return a.size() > b.size(); });
+        for (int k : {1, 5, 20}) {
+            CliqueSearchStats stats;
+            vector<set<int>> top = g.find_top_k_cliques<TomitaPivot>(k, CliqueSearchOptions(), stats);
+            assert(static_cast<int>(top.size()) == k);
+            for (int i = 0; i < k; ++i) {
+                assert(top[i].size() == all_cliques[i].size() && is_clique(g, top[i]));
+                assert(find(all_cliques.begin(), all_cliques.end(), top[i]) != all_cliques.end());
+            }
+        }
+        cout << "Top-k, G(60, 0.5) seed " << seed << ": Passed!" << endl;
+    }
+
+    cout << "\nAll streaming, parallel and top-k tests passed!" << endl;
+}
+
+void test_cliques_containing_vertex() {
+    cout << "\nRunning tests for cliques containing a vertex..." << endl;
+
+    // Test Case 1: The cliques containing v are exactly the maximal cliques of the graph with v in them
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Graph g = make_random_graph(50, 0.4, seed);
+        vector<set<int>> all_cliques = g.find_max_cliques();
+        for (int v = 0; v < g.num_vertices; ++v) {
+            vector<set<int>> expected;
+            for (const auto& clique : all_cliques) {
+                if (clique.count(v)) expected.push_back(clique);
+            }
+            vector<set<int>> actual = g.find_max_cliques_containing(v);
+            sort(expected.begin(), expected.end());
+            sort(actual.begin(), actual.end());
+            assert(actual == expected);
+
+            CliqueSearchStats stats;
+            vector<set<int>> largest = g.find_top_k_cliques_containing<TomitaPivot>(v, 1, CliqueSearchOptions(), stats);
+            size_t max_size = 0;
+            for (const auto& clique : expected) max_size = max(max_size, clique.size());
+            assert(largest.size() == 1 && largest[0].size() == max_size && largest[0].count(v));
+        }
+        cout << "All vertices, G(50, 0.4) seed " << seed << ": Passed!" << endl;
+    }
+
+    // Test Case 2: Size bounds, isolated and out-of-range vertices
+    {
+        Graph g(6);
+        g.add_edge(0, 1);
+        g.add_edge(0, 2);
+        g.add_edge(1, 2);
+        g.add_edge(2, 3);
+        g.add_edge(3, 4);
+        CliqueSearchOptions options;
+        options.min_size = 3;
+        CliqueSearchStats stats;
+        vector<set<int>> cliques;
+        g.for_each_max_clique_containing(2, [&](const set<int>& clique) { cliques.push_back(clique); }, options, stats);
+        assert(cliques == vector<set<int>>({{0, 1, 2}}));
+        assert(g.find_max_cliques_containing(5) == vector<set<int>>({{5}}));
+        assert(g.find_max_cliques_containing(6).empty() && g.find_max_cliques_containing(-1).empty());
+        cout << "Size bounds and edge cases: Passed!" << endl;
+    }
+
+    // Test Case 3: The neighborhood-local min_size filter and orderings, after edge updates
+    {
+        Graph g = make_random_graph(60, 0.5, 7);
+        for (int u = 0; u < 60; u += 7) {
+            g.remove_edge(u, (u * 3 + 1) % 60);
+            g.add_edge(u, (u * 5 + 2) % 60);
+            g.add_edge(u, u);
+            g.remove_edge(u, u);
+        }
+        vector<set<int>> all_cliques = g.find_max_cliques();
+        for (VertexOrdering ordering : {VertexOrdering::VertexId, VertexOrdering::DegreeAscending, VertexOrdering::CoreAscending}) {
+            for (int min_size : {3, 5, 6}) {
+                CliqueSearchOptions options;
+                options.min_size = min_size;
+                options.ordering = ordering;
+                for (int v = 0; v < g.num_vertices; v += 3) {
+                    vector<set<int>> expected, actual;
+                    for (const auto& clique : all_cliques) {
+                        if (clique.count(v) && static_cast<int>(clique.size()) >= min_size) expected.push_back(clique);
+                    }
+                    CliqueSearchStats stats;
+                    g.for_each_max_clique_containing(v, [&](const set<int>& clique) { actual.push_back(clique); }, options, stats);
+                    sort(expected.begin(), expected.end());
+                    sort(actual.begin(), actual.end());
+                    assert(actual == expected);
+                }
+            }
+        }
+        cout << "Local min_size filter and orderings: Passed!" << endl;
+    }
+
+    cout << "\nAll tests for cliques containing a vertex passed!" << endl;
+}
+
+void test_clique_cache() {
+    cout << "\nRunning tests for the subgraph clique cache..." << endl;
+
+    auto sorted = [](vector<set<int>> cliques) {
+        sort(cliques.begin(), cliques.end());
+        return cliques;
+    };
+
+    // Test Case 1: Cached answers match the uncached searches, and repeats are hits
+    {
+        Graph g = make_random_graph(60, 0.3, 4);
+        CliqueCache cache(1 << 24);
+        assert(sorted(cache.max_cliques(g)) == sorted(g.find_max_cliques()));
+        for (int round = 0; round < 2; ++round) {
+            for (int v = 0; v < g.num_vertices; ++v) {
+                vector<set<int>> expected = sorted(g.find_max_cliques_containing(v));
+                assert(sorted(cache.max_cliques_containing(g, v)) == expected);
+                assert(cache.count_max_cliques_containing(g, v) == expected.size());
+            }
+        }
+        CliqueCacheStats stats = cache.stats();
+        assert(stats.hits >= 3 * g.num_vertices && stats.evictions == 0 && stats.bytes > 0);
+        cout << "Cached results, G(60, 0.3): Passed!" << endl;
+    }
+
+    // Test Case 2: Identical induced subgraphs on different vertices share an entry
+    {
+        // Two disjoint copies of the house graph, the second on vertices 10..14.
+        Graph g(15);
+        for (int offset : {0, 10}) {
+            for (auto e : vector<pair<int, int>>{{0, 1}, {1, 2}, {2, 3}, {3, 0}, {0, 4}, {1, 4}}) {
+                g.add_edge(e.first + offset, e.second + offset);
+            }
+        }
+        CliqueCache cache(1 << 20);
+        assert(sorted(cache.max_cliques_induced(g, {0, 1, 2, 3, 4})) ==
+               sorted({{0, 1, 4}, {1, 2}, {2, 3}, {0, 3}}));
+        assert(sorted(cache.max_cliques_induced(g, {10, 11, 12, 13, 14})) ==
+               sorted({{10, 11, 14}, {11, 12}, {12, 13}, {10, 13}}));
+        CliqueCacheStats stats = cache.stats();
+        assert(stats.hits == 1 && stats.misses == 1 && stats.entries == 1);
+        assert(cache.max_cliques_containing(g, 5) == vector<set<int>>({{5}}));
+        assert(cache.count_max_cliques_containing(g, 5) == 1);
+        assert(cache.max_cliques_induced(g, {}).empty());
+        cout << "Shared entries for cloned subgraphs: Passed!" << endl;
+    }
+
+    // Test Case 3: The memory budget bounds the cache
+    {
+        Graph g = make_random_graph(80, 0.3, 6);
+        CliqueCache cache(4096);
+        for (int v = 0; v < g.num_vertices; ++v) {
+            assert(sorted(cache.max_cliques_containing(g, v)) == sorted(g.find_max_cliques_containing(v)));
+            assert(cache.stats().bytes <= 4096);
+        }
+        assert(cache.stats().evictions > 0);
+        cache.clear();
+        assert(cache.stats().entries == 0 && cache.stats().bytes == 0);
+        cout << "Memory budget: Passed!" << endl;
+    }
+
+    cout << "\nAll subgraph clique cache tests passed!" << endl;
+}
+
+void test_twin_reduction() {
+    cout << "\nRunning tests for twin-class symmetry reduction..." << endl;
+
+    auto expanded = [](TwinReduction& reduction) {
+        vector<set<int>> cliques;
+        CliqueSearchStats stats;
+        reduction.for_each_max_clique([&](const set<int>& clique) { cliques.push_back(clique); }, stats);
+        sort(cliques.begin(), cliques.end());
+        return cliques;
+    };
+    auto sorted_cliques = [](Graph& g) {
+        vector<set<int>> cliques = g.find_max_cliques();
+        sort(cliques.begin(), cliques.end());
+        return cliques;
+    };
+
+    // Test Case 1: Complete bipartite K(3,3) reduces to one vertex: all of {0,1,2} | {3,4,5}
+    {
+        Graph g(6);
+        for (int u = 0; u < 3; ++u) {
+            for (int v = 3; v < 6; ++v) g.add_edge(u, v);
+        }
+        TwinReduction reduction(g);
+        assert(reduction.quotient.num_vertices == 1);
+        assert(reduction.find_max_clique_orbits() == vector<vector<int>>({{0}}));
+        assert(reduction.members(0) == vector<int>({0, 1, 2, 3, 4, 5}));
+        assert(reduction.node(0).kind == TwinNode::Kind::All && reduction.node(0).children.size() == 2);
+        assert(expanded(reduction) == sorted_cliques(g) && expanded(reduction).size() == 9);
+        cout << "K(3,3): Passed!" << endl;
+    }
+
+    // Test Case 2: Cliques and Moon-Moser graphs collapse to a single vertex
+    {
+        Graph k5(5);
+        for (int u = 0; u < 5; ++u) {
+            for (int v = u + 1; v < 5; ++v) k5.add_edge(u, v);
+        }
+        TwinReduction clique_reduction(k5);
+        assert(clique_reduction.quotient.num_vertices == 1 && clique_reduction.node(0).kind == TwinNode::Kind::All);
+        assert(expanded(clique_reduction) == vector<set<int>>({{0, 1, 2, 3, 4}}));
+
+        Graph moon_moser = make_moon_moser_graph(6);
+        TwinReduction reduction(moon_moser);
+        CliqueSearchStats stats;
+        long long count = 0;
+        reduction.for_each_max_clique([&](const set<int>&) { count++; }, stats);
+        assert(count == 729 && stats.cliques == 1);
+        assert(expanded(reduction) == sorted_cliques(moon_moser));
+        cout << "Cliques and Moon-Moser graphs: Passed!" << endl;
+    }
+
+    // Test Case 3: Random graphs with planted twins give exactly the maximal cliques of the original graph
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        Graph base = make_random_graph(25, 0.4, seed);
+        // Vertex 25 + i is a copy of vertex i < 15: a true twin for even i, a false twin for odd i.
+        Graph g(40);
+        auto original = [](int v) { return v < 25 ? v : v - 25; };
+        for (int u = 0; u < 40; ++u) {
+            for (int v = u + 1; v < 40; ++v) {
+                if (base.adj_matrix[original(u)][original(v)] || (original(u) == original(v) && u % 2 == 0)) {
+                    g.add_edge(u, v);
+                }
+            }
+        }
+        TwinReduction reduction(g);
+        assert(reduction.quotient.num_vertices < 40);
+        assert(expanded(reduction) == sorted_cliques(g));
+        cout << "Planted twins, seed " << seed << ": Passed!" << endl;
+    }
+
+    cout << "\nAll twin reduction tests passed!" << endl;
+}
+
+void test_clique_families() {
+    cout << "\nRunning tests for orbit-compressed clique families..." << endl;
+
+    auto families_of = [](TwinReduction& reduction) {
+        vector<CliqueFamily> families;
+        CliqueSearchStats stats;
+        reduction.for_each_clique_family([&](const CliqueFamily& family) { families.push_back(family); }, stats);
+        return families;
+    };
+
+    // Test Case 1: K(3,3) is the single family {0,1,2} x {3,4,5}
+    {
+        Graph g(6);
+        for (int u = 0; u < 3; ++u) {
+            for (int v = 3; v < 6; ++v) g.add_edge(u, v);
+        }
+        TwinReduction reduction(g);
+        vector<CliqueFamily> families = families_of(reduction);
+        assert(families.size() == 1);
+        assert(families[0].to_string() == "{0,1,2} {3,4,5}");
+        assert(families[0].count() == 9 && reduction.count_max_cliques() == 9);
+        vector<set<int>> cliques = families[0].expand();
+        vector<set<int>> expected = g.find_max_cliques();
+        sort(cliques.begin(), cliques.end());
+        sort(expected.begin(), expected.end());
+        assert(cliques == expected);
+        cout << "K(3,3): Passed!" << endl;
+    }
+
+    // Test Case 2: Nested families: two true-twin pairs that are false twins of each other, plus a hub
+    {
+        Graph g(5);
+        g.add_edge(0, 1);
+        g.add_edge(2, 3);
+        for (int v = 0; v < 4; ++v) g.add_edge(v, 4);
+        TwinReduction reduction(g);
+        vector<CliqueFamily> families = families_of(reduction);
+        assert(families.size() == 1 && families[0].count() == 2);
+        assert(families[0].to_string() == "{(0 1),(2 3)} 4");
+        assert(families[0].expand() == vector<set<int>>({{0, 1, 4}, {2, 3, 4}}));
+        cout << "Nested families: Passed!" << endl;
+    }
+
+    // Test Case 3: Counting without expansion, and the iterator against the search on random graphs with twins
+    {
+        TwinReduction moon_moser(make_moon_moser_graph(30));
+        assert(moon_moser.count_max_cliques() == 205891132094649ull);  // 3^30
+        cout << "Count of Moon-Moser k = 30: Passed!" << endl;
+    }
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        Graph base = make_random_graph(20, 0.3, seed);
+        // Every vertex gets two copies; vertices divisible by 3 are adjacent to their second copy.
+        Graph g(60);
+        auto original = [](int v) { return v % 20; };
+        for (int u = 0; u < 60; ++u) {
+            for (int v = u + 1; v < 60; ++v) {
+                bool twins = original(u) == original(v) && (u >= 40 || v >= 40) && original(u) % 3 == 0 &&
+                             (u < 20 || v < 20);
+                if (base.adj_matrix[original(u)][original(v)] || twins) g.add_edge(u, v);
+            }
+        }
+        TwinReduction reduction(g);
+        vector<set<int>> cliques;
+        uint64_t counted = 0;
+        for (const CliqueFamily& family : families_of(reduction)) {
+            counted += family.count();
+            for (const set<int>& clique : family) {
+                cliques.push_back(clique);
+            }
+        }
+        vector<set<int>> expected = g.find_max_cliques();
+        sort(cliques.begin(), cliques.end());
+        sort(expected.begin(), expected.end());
+        assert(counted == expected.size() && cliques == expected);
+        cout << "Families with twins, seed " << seed << ": Passed!" << endl;
+    }
+
+    cout << "\nAll clique family tests passed!" << endl;
+}
+
+void test_roaring_bitmap() {
+    cout << "\nRunning tests for RoaringBitmap..." << endl;
+
+    auto values_of = [](const RoaringBitmap& bitmap) {
+        vector<int> values;
+        bitmap.for_each([&](int v) { values.push_back(v); });
+        return values;
+    };
+    // Random sets mixing sparse chunks (array containers), dense chunks (bitmaps) and long ranges (runs).
+    auto make_set = [](unsigned seed) {
+        mt19937 rng(seed);
+        set<int> values;
+        for (int i = 0; i < 3000; ++i) values.insert(rng() % 1000000);
+        for (int i = 0; i < 20000; ++i) values.insert(131072 + rng() % 30000);
+        int start = 262144 + rng() % 1000;
+        for (int v = start; v < start + 50000; ++v) values.insert(v);
+        return values;
+    };
+
+    // Test Case 1: Set operations agree with std::set, before and after run_optimize
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        set<int> a = make_set(seed), b = make_set(seed + 100);
+        for (bool optimize : {false, true}) {
+            RoaringBitmap ra = RoaringBitmap::from_sorted(vector<int>(a.begin(), a.end()));
+            RoaringBitmap rb = RoaringBitmap::from_sorted(vector<int>(b.begin(), b.end()));
+            if (optimize) {
+                size_t before = ra.memory_bytes();
+                ra.run_optimize();
+                rb.run_optimize();
+                assert(ra.memory_bytes() < before);
+            }
+            vector<int> both, only_a;
+            set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(both));
+            set_difference(a.begin(), a.end(), b.begin(), b.end(), back_inserter(only_a));
+            assert(ra.size() == a.size() && values_of(ra) == vector<int>(a.begin(), a.end()));
+            assert(values_of(ra.intersect(rb)) == both && ra.intersection_size(rb) == both.size());
+            assert(values_of(ra.difference(rb)) == only_a);
+            assert(ra.intersect(rb) == rb.intersect(ra));
+        }
+        cout << "Set operations, seed " << seed << ": Passed!" << endl;
+    }
+
+    // Test Case 2: Point updates move containers between representations
+    {
+        RoaringBitmap bitmap;
+        set<int> reference;
+        mt19937 rng(7);
+        for (int i = 0; i < 20000; ++i) {
+            int v = rng() % 10000;
+            if (rng() % 3 == 0) {
+                bitmap.remove(v);
+                reference.erase(v);
+            } else {
+                bitmap.add(v);
+                reference.insert(v);
+            }
+            if (i % 1000 == 0) {
+                assert(bitmap.contains(v) == (reference.count(v) > 0));
+            }
+        }
+        assert(values_of(bitmap) == vector<int>(reference.begin(), reference.end()));
+        for (int v : vector<int>(reference.begin(), reference.end())) bitmap.remove(v);
+        assert(bitmap.empty() && bitmap.size() == 0);
+        cout << "Point updates: Passed!" << endl;
+    }
+
+    cout << "\nAll RoaringBitmap tests passed!" << endl;
+}
+
+void test_sparse_engine() {
+    cout << "\nRunning tests for the sparse engine..." << endl;
+
+    auto sorted = [](vector<set<int>> cliques) {
+        sort(cliques.begin(), cliques.end());
+        return cliques;
+    };
+
+    // Test Case 1: Same cliques as Graph, with size bounds and several threads
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Graph g = make_random_graph(70, 0.3, seed);
+        SparseCliqueEngine<RoaringBitmap> engine(g);
+        assert(sorted(engine.find_max_cliques()) == sorted(g.find_max_cliques()));
+        for (auto bounds : vector<pair<int, int>>{{3, 100}, {1, 2}, {4, 4}}) {
+            CliqueSearchOptions options;
+            options.min_size = bounds.first;
+            options.max_size = bounds.second;
+            for (int threads : {1, 3}) {
+                vector<set<int>> cliques;
+                CliqueSearchStats stats;
+                engine.for_each_max_clique([&](const set<int>& clique) { cliques.push_back(clique); }, options, stats,
+                                           threads);
+                assert(stats.cliques == static_cast<long long>(cliques.size()));
+                // Truncated cliques depend on the search order; the rest must match exactly.
+                vector<set<int>> exact, expected_exact;
+                for (const auto& clique : cliques) {
+                    assert(is_clique(g, clique) && static_cast<int>(clique.size()) >= options.min_size &&
+                           static_cast<int>(clique.size()) <= options.max_size);
+                    if (static_cast<int>(clique.size()) < options.max_size) exact.push_back(clique);
+                }
+                for (const auto& clique : g.find_max_cliques()) {
+                    if (static_cast<int>(clique.size()) >= options.min_size &&
+                        static_cast<int>(clique.size()) < options.max_size) {
+                        expected_exact.push_back(clique);
+                    }
+                }
+                assert(sorted(exact) == sorted(expected_exact));
+            }
+        }
+        cout << "G(70, 0.3) seed " << seed << ": Passed!" << endl;
+    }
+
+    // Test Case 2: Edge lists with self-loops, duplicates and isolated vertices; degeneracy
+    {
+        SparseCliqueEngine<RoaringBitmap> engine(6, {{0, 1}, {1, 2}, {2, 0}, {2, 0}, {3, 3}, {2, 3}, {4, 2}});
+        assert(sorted(engine.find_max_cliques()) == sorted({{0, 1, 2}, {2, 3}, {2, 4}, {5}}));
+        assert(engine.degeneracy() == 2);
+        Graph moon_moser = make_moon_moser_graph(5);
+        SparseCliqueEngine<RoaringBitmap> dense(moon_moser);
+        assert(dense.degeneracy() == 12 && dense.find_max_cliques().size() == 243);
+        cout << "Edge lists and degeneracy: Passed!" << endl;
+    }
+
+    // Test Case 3: Disjoint triangles {v, v + 65536, v + 131072} spanning three chunks of the bitmaps
+    {
+        int n = 200000;
+        vector<pair<int, int>> edges;
+        int triangles = 0;
+        for (int v = 0; v < 60000; v += 1000, ++triangles) {
+            edges.push_back({v, v + 65536});
+            edges.push_back({v + 65536, v + 131072});
+            edges.push_back({v, v + 131072});
+        }
+        SparseCliqueEngine<RoaringBitmap> engine(n, edges);
+        CliqueSearchOptions options;
+        options.min_size = 3;
+        vector<set<int>> cliques;
+        CliqueSearchStats stats;
+        engine.for_each_max_clique([&](const set<int>& clique) { cliques.push_back(clique); }, options, stats);
+        assert(static_cast<int>(cliques.size()) == triangles && sorted(cliques)[1] == set<int>({1000, 66536, 132072}));
+        assert(static_cast<int>(engine.find_max_cliques().size()) == triangles + n - 3 * triangles);
+        cout << "Large vertex ids: Passed!" << endl;
+    }
+
+    // Test Case 4: An exception thrown by the callback reaches the caller, with either engine
+    {
+        Graph g = make_random_graph(80, 0.3, 7);
+        SparseCliqueEngine<RoaringBitmap> roaring(g);
+        PartitionCliqueEngine partition(g);
+        CliqueCallback fail = [](const set<int>&) { throw runtime_error("write failed"); };
+        for (int threads : {1, 3}) {
+            int caught = 0;
+            CliqueSearchStats stats;
+            try {
+                roaring.for_each_max_clique(fail, CliqueSearchOptions(), stats, threads);
+            } catch (const runtime_error&) {
+                caught++;
+            }
+            try {
+                partition.for_each_max_clique(fail, CliqueSearchOptions(), stats, threads);
+            } catch (const runtime_error&) {
+                caught++;
+            }
+            assert(caught == 2);
+        }
+        cout << "Throwing callback: Passed!" << endl;
+    }
+
+    cout << "\nAll sparse engine tests passed!" << endl;
+}
+
+void test_intersection_kernels() {
+    cout << "\nRunning tests for the sorted intersection kernels..." << endl;
+
+    mt19937 rng(11);
+    auto random_sorted = [&](size_t size, int universe) {
+        vector<int> values;
+        uniform_int_distribution<int> pick(0, universe - 1);
+        for (size_t i = 0; i < size; ++i) values.push_back(pick(rng));
+        sort(values.begin(), values.end());
+        values.erase(unique(values.begin(), values.end()), values.end());
+        return values;
+    };
+    auto expected = [](const vector<int>& a, const vector<int>& b) {
+        vector<int> result;
+        set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(result));
+        return result;
+    };
+
+    // Test Case 1: Every kernel agrees with std::set_intersection, for equal and very unequal sizes
+    {
+        for (auto sizes : vector<pair<size_t, size_t>>{{0, 10}, {1, 1}, {5, 7}, {16, 16}, {37, 50}, {200, 300},
+                                                       {3, 1000}, {40, 5000}, {1000, 1000}}) {
+            for (int universe : {64, 1000, 100000}) {
+                vector<int> a = random_sorted(sizes.first, universe);
+                vector<int> b = random_sorted(sizes.second, universe);
+                vector<int> want = expected(a, b);
+                vector<int> out(min(a.size(), b.size()) + 1);
+                auto run = [&](size_t (*kernel)(const int*, size_t, const int*, size_t, int*), bool swap_inputs) {
+                    size_t k = swap_inputs ? kernel(b.data(), b.size(), a.data(), a.size(), out.data())
+                                           : kernel(a.data(), a.size(), b.data(), b.size(), out.data());
+                    return vector<int>(out.begin(), out.begin() + k);
+                };
+                for (bool swap_inputs : {false, true}) {
+                    assert(run(intersection::merge_branchless, swap_inputs) == want);
+                    assert(run(intersection::simd_4x4, swap_inputs) == want);
+                    assert(run(intersection::adaptive, swap_inputs) == want);
+                }
+                assert(run(intersection::gallop, false) == want);
+                assert(intersection::count(a.data(), a.size(), b.data(), b.size()) == want.size());
+                assert(intersection::count(b.data(), b.size(), a.data(), a.size()) == want.size());
+            }
+        }
+        cout << "Kernels: Passed!" << endl;
+    }
+
+    // Test Case 2: The fused split of disjoint P and X against N, in both of its regimes
+    {
+        for (auto sizes : vector<pair<int, int>>{{0, 0}, {10, 0}, {0, 10}, {30, 40}, {3, 2}}) {
+            for (int universe : {200, 5000}) {
+                vector<int> all = random_sorted(sizes.first + sizes.second, universe);
+                shuffle(all.begin(), all.end(), rng);
+                size_t np = min(all.size(), static_cast<size_t>(sizes.first));
+                vector<int> p(all.begin(), all.begin() + np), x(all.begin() + np, all.end());
+                sort(p.begin(), p.end());
+                sort(x.begin(), x.end());
+                vector<int> n = random_sorted(universe / 4, universe);
+                SortedVertexSet new_p, new_x;
+                SortedVertexSet::intersect_pair(SortedVertexSet::from_sorted(p), SortedVertexSet::from_sorted(x),
+                                                SortedVertexSet::from_sorted(n), new_p, new_x);
+                assert(new_p == SortedVertexSet::from_sorted(expected(p, n)));
+                assert(new_x == SortedVertexSet::from_sorted(expected(x, n)));
+            }
+        }
+        cout << "Fused P/X split: Passed!" << endl;
+    }
+
+    // Test Case 3: SparseCliqueEngine on sorted vertex sets matches Graph
+    {
+        auto sorted = [](vector<set<int>> cliques) {
+            sort(cliques.begin(), cliques.end());
+            return cliques;
+        };
+        for (unsigned seed = 1; seed <= 3; ++seed) {
+            Graph g = make_random_graph(80, 0.25, seed);
+            SparseCliqueEngine<SortedVertexSet> engine(g);
+            assert(sorted(engine.find_max_cliques()) == sorted(g.find_max_cliques()));
+        }
+        Graph moon_moser = make_moon_moser_graph(6);
+        SparseCliqueEngine<SortedVertexSet> dense(moon_moser);
+        assert(dense.find_max_cliques().size() == 729);
+        cout << "Sorted engine: Passed!" << endl;
+    }
+
+    cout << "\nAll intersection kernel tests passed!" << endl;
+}
+
+void test_partition_engine() {
+    cout << "\nRunning tests for the partition engine..." << endl;
+
+    auto sorted = [](vector<set<int>> cliques) {
+        sort(cliques.begin(), cliques.end());
+        return cliques;
+    };
+
+    // Test Case 1: Same cliques as Graph, with size bounds and several threads
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        for (double density : {0.1, 0.3, 0.6}) {
+            Graph g = make_random_graph(70, density, seed);
+            PartitionCliqueEngine engine(g);
+            vector<set<int>> expected = g.find_max_cliques();
+            assert(sorted(engine.find_max_cliques()) == sorted(expected));
+            for (auto bounds : vector<pair<int, int>>{{3, 100}, {1, 2}, {4, 4}}) {
+                CliqueSearchOptions options;
+                options.min_size = bounds.first;
+                options.max_size = bounds.second;
+                for (int threads : {1, 3}) {
+                    vector<set<int>> cliques;
+                    CliqueSearchStats stats;
+                    engine.for_each_max_clique([&](const set<int>& clique) { cliques.push_back(clique); }, options,
+                                               stats, threads);
+                    assert(stats.cliques == static_cast<long long>(cliques.size()));
+                    // Truncated cliques depend on the search order; the rest must match exactly.
+                    vector<set<int>> exact, expected_exact;
+                    for (const auto& clique : cliques) {
+                        assert(is_clique(g, clique) && static_cast<int>(clique.size()) >= options.min_size &&
+                               static_cast<int>(clique.size()) <= options.max_size);
+                        if (static_cast<int>(clique.size()) < options.max_size) exact.push_back(clique);
+                    }
+                    for (const auto& clique : expected) {
+                        if (static_cast<int>(clique.size()) >= options.min_size &&
+                            static_cast<int>(clique.size()) < options.max_size) {
+                            expected_exact.push_back(clique);
+                        }
+                    }
+                    assert(sorted(exact) == sorted(expected_exact));
+                }
+            }
+        }
+        cout << "G(70, p) seed " << seed << ": Passed!" << endl;
+    }
+
+    // Test Case 2: Edge lists, Moon-Moser graphs and a hub whose neighborhood is far longer than P
+    {
+        PartitionCliqueEngine engine(6, {{0, 1}, {1, 2}, {2, 0}, {2, 0}, {3, 3}, {2, 3}, {4, 2}});
+        assert(sorted(engine.find_max_cliques()) == sorted({{0, 1, 2}, {2, 3}, {2, 4}, {5}}));
+        assert(engine.degeneracy() == 2 && engine.degree(2) == 4);
+        PartitionCliqueEngine moon_moser(make_moon_moser_graph(6));
+        assert(moon_moser.find_max_cliques().size() == 729);
+        // A star of 5000 leaves plus triangles through the hub.
+        vector<pair<int, int>> edges;
+        for (int v = 1; v <= 5000; ++v) edges.push_back({0, v});
+        for (int v = 1; v < 5000; v += 2) edges.push_back({v, v + 1});
+        PartitionCliqueEngine hub(5001, edges);
+        vector<set<int>> cliques = hub.find_max_cliques();
+        assert(cliques.size() == 2500 && sorted(cliques)[0] == set<int>({0, 1, 2}));
+        cout << "Edge lists and hubs: Passed!" << endl;
+    }
+
+    cout << "\nAll partition engine tests passed!" << endl;
+}
+
+void test_memory_budget() {
+    cout << "\nRunning tests for memory accounting..." << endl;
+
+    // Test Case 1: Peak and retained memory of a collecting and a streaming search
+    {
+        Graph g = make_random_graph(60, 0.5, 4);
+        CliqueSearchStats stats;
+        vector<set<int>> cliques = g.find_max_cliques_with_pivot<TomitaPivot>(CliqueSearchOptions(), stats);
+        size_t output_bytes = 0;
+        for (const auto& clique : cliques) output_bytes += set_memory_bytes(clique);
+        assert(!stats.memory_exceeded && stats.memory_current == output_bytes && stats.memory_peak > output_bytes);
+        g.for_each_max_clique([](const set<int>&) {}, CliqueSearchOptions(), stats);
+        assert(stats.memory_current == 0 && stats.memory_peak > 0 && stats.memory_peak < output_bytes);
+        cout << "Peak and current: Passed!" << endl;
+    }
+
+    // Test Case 2: A hard limit stops every engine cleanly with valid partial results
+    {
+        Graph g = make_moon_moser_graph(8);
+        auto check_partial = [&](const vector<set<int>>& cliques, const CliqueSearchStats& stats, MemoryBudget& budget) {
+            assert(stats.memory_exceeded && budget.exceeded() && budget.current() == 0);
+            assert(cliques.size() < 6561);
+            for (const auto& clique : cliques) assert(clique.size() == 8 && is_clique(g, clique));
+        };
+        {
+            MemoryBudget budget(64 << 10);
+            CliqueSearchOptions options;
+            options.memory = &budget;
+            CliqueSearchStats stats;
+            vector<set<int>> cliques = g.find_max_cliques_with_pivot<TomitaPivot>(options, stats);
+            check_partial(cliques, stats, budget);
+            assert(!cliques.empty() && budget.peak() > budget.limit());
+        }
+        // Streaming searches hold only their scratch, so they get half of their unlimited peak.
+        auto check_streaming = [&](auto run) {
+            CliqueSearchStats stats;
+            run([](const set<int>&) {}, CliqueSearchOptions(), stats);
+            assert(stats.memory_peak > 0 && !stats.memory_exceeded);
+            MemoryBudget budget(stats.memory_peak / 2);
+            CliqueSearchOptions options;
+            options.memory = &budget;
+            vector<set<int>> cliques;
+            run([&](const set<int>& clique) { cliques.push_back(clique); }, options, stats);
+            check_partial(cliques, stats, budget);
+        };
+        check_streaming([&](const CliqueCallback& cb, const CliqueSearchOptions& options, CliqueSearchStats& stats) {
+            g.for_each_max_clique_parallel<TomitaPivot>(cb, 3, options, stats);
+        });
+        SparseCliqueEngine<SortedVertexSet> sparse(g);
+        check_streaming([&](const CliqueCallback& cb, const CliqueSearchOptions& options, CliqueSearchStats& stats) {
+            sparse.for_each_max_clique(cb, options, stats, 2);
+        });
+        PartitionCliqueEngine partition(g);
+        check_streaming([&](const CliqueCallback& cb, const CliqueSearchOptions& options, CliqueSearchStats& stats) {
+            partition.for_each_max_clique(cb, options, stats);
+        });
+        // Deterministic searches also buffer the cliques of every root, and must release the failed charges.
+        for (size_t limit : {size_t(8) << 10, size_t(32) << 10}) {
+            MemoryBudget budget(limit);
+            CliqueSearchOptions options;
+            options.memory = &budget;
+            options.deterministic = true;
+            CliqueSearchStats stats;
+            vector<set<int>> cliques;
+            sparse.for_each_max_clique([&](const set<int>& clique) { cliques.push_back(clique); }, options, stats, 3);
+            check_partial(cliques, stats, budget);
+        }
+        cout << "Hard limit: Passed!" << endl;
+    }
+
+    // Test Case 3: An on_exceeded handler that spills buffered output lets the search finish
+    {
+        Graph g = make_moon_moser_graph(8);
+        MemoryBudget budget(64 << 10);
+        vector<set<int>> buffered, spilled;
+        int spills = 0;
+        budget.on_exceeded = [&](MemoryBudget& b) {
+            for (const auto& clique : buffered) b.release(set_memory_bytes(clique));
+            spilled.insert(spilled.end(), buffered.begin(), buffered.end());
+            buffered.clear();
+            spills++;
+            return true;
+        };
+        CliqueSearchOptions options;
+        options.memory = &budget;
+        CliqueSearchStats stats;
+        g.for_each_max_clique(
+            [&](const set<int>& clique) {
+                buffered.push_back(clique);
+                budget.charge(set_memory_bytes(clique));
+            },
+            options, stats, TomitaPivot());
+        assert(!stats.memory_exceeded && spills > 0);
+        assert(spilled.size() + buffered.size() == 6561);
+        cout << "Spilling handler: Passed!" << endl;
+    }
+
+    cout << "\nAll memory accounting tests passed!" << endl;
+}
+
+void test_clique_store() {
+    cout << "\nRunning tests for the spilling clique store..." << endl;
+
+    auto read_all = [](const CliqueStore& store, bool sorted) {
+        vector<set<int>> cliques;
+        store.for_each([&](const vector<int>& clique) { cliques.push_back(set<int>(clique.begin(), clique.end())); },
+                       sorted);
+        return cliques;
+    };
+    auto sorted_copy = [](vector<set<int>> cliques) {
+        sort(cliques.begin(), cliques.end());
+        return cliques;
+    };
+
+    // Test Case 1: Many small runs merge back into canonical order
+    {
+        Graph g = make_random_graph(120, 0.4, 9);
+        vector<set<int>> expected = sorted_copy(g.find_max_cliques());
+        CliqueStore store(4 << 10);
+        CliqueSearchStats stats;
+        g.for_each_max_clique(store.collector(), CliqueSearchOptions(), stats, TomitaPivot());
+        assert(store.size() == expected.size() && store.num_runs() > 10);
+        assert(read_all(store, true) == expected);
+        assert(sorted_copy(read_all(store, false)) == expected);
+        // Reading twice gives the same result.
+        assert(read_all(store, true) == expected);
+        size_t raw_bytes = 0;
+        for (const auto& clique : expected) raw_bytes += (clique.size() + 1) * sizeof(int);
+        assert(store.spilled_bytes() < raw_bytes / 2);
+        cout << "Spilled runs: Passed!" << endl;
+    }
+
+    // Test Case 2: Collecting a parallel search, and spilling on demand
+    {
+        Graph g = make_moon_moser_graph(7);
+        CliqueStore store(16 << 10);
+        CliqueSearchStats stats;
+        g.for_each_max_clique_parallel<TomitaPivot>(store.collector(), 3, CliqueSearchOptions(), stats);
+        assert(store.size() == 2187);
+        size_t runs = store.num_runs();
+        assert(store.spill() > 0 && store.num_runs() == runs + 1 && store.spill() == 0);
+        vector<set<int>> cliques = read_all(store, true);
+        assert(cliques == sorted_copy(g.find_max_cliques()));
+        cout << "Parallel collection: Passed!" << endl;
+    }
+
+    // Test Case 3: Buffer-only stores, empty cliques, duplicates and large vertex ids
+    {
+        CliqueStore store;
+        assert(read_all(store, true).empty());
+        vector<set<int>> added = {{5, 1000000}, {}, {2, 3}, {2, 3}, {1, 2, 3}, {7}};
+        for (const auto& clique : added) store.add(clique);
+        assert(store.num_runs() == 0 && read_all(store, false) == added);
+        assert(read_all(store, true) == sorted_copy(added));
+        store.spill();
+        store.add({0, 2147483000});
+        added.push_back({0, 2147483000});
+        assert(read_all(store, true) == sorted_copy(added));
+        cout << "Edge cases: Passed!" << endl;
+    }
+
+    // Test Case 4: Sorting a sparse engine's output through a store charged to the search's budget
+    {
+        Graph g = make_moon_moser_graph(8);
+        vector<set<int>> expected = sorted_copy(g.find_max_cliques());
+        PartitionCliqueEngine partition(g);
+        SparseCliqueEngine<RoaringBitmap> roaring(g);
+        for (int threads : {1, 3}) {
+            for (int engine = 0; engine < 2; ++engine) {
+                auto search = [&](CliqueStore& store, MemoryBudget& budget, CliqueSearchStats& stats) {
+                    CliqueSearchOptions options;
+                    options.memory = &budget;
+                    if (engine == 0) {
+                        partition.for_each_max_clique(store.collector(), options, stats, threads);
+                    } else {
+                        roaring.for_each_max_clique(store.collector(), options, stats, threads);
+                    }
+                };
+                // A buffer well below the limit spills, and the whole output fits in the budget.
+                MemoryBudget budget(size_t(64) << 10);
+                {
+                    CliqueStore store(8 << 10, "", &budget);
+                    CliqueSearchStats stats;
+                    search(store, budget, stats);
+                    assert(!stats.memory_exceeded && store.num_runs() > 0);
+                    assert(stats.memory_peak > store.buffered_bytes() && budget.current() == store.buffered_bytes());
+                    assert(read_all(store, true) == expected);
+                }
+                assert(budget.current() == 0);
+                // A buffer larger than the limit stops the search once it has outgrown the budget.
+                MemoryBudget tight(size_t(16) << 10);
+                {
+                    CliqueStore store(size_t(1) << 20, "", &tight);
+                    CliqueSearchStats stats;
+                    search(store, tight, stats);
+                    assert(stats.memory_exceeded && store.num_runs() == 0 && store.size() < expected.size());
+                }
+                assert(tight.current() == 0);
+            }
+        }
+        cout << "Charged to a memory budget: Passed!" << endl;
+    }
+
+    cout << "\nAll clique store tests passed!" << endl;
+}
+
+void test_sorted_output() {
+    cout << "\nRunning tests for canonical sorted output..." << endl;
+
+    auto sorted_copy = [](vector<set<int>> cliques) {
+        sort(cliques.begin(), cliques.end());
+        return cliques;
+    };
+
+    // Test Case 1: Same order as sorting the results, for any thread count and size bounds
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Graph g = make_random_graph(80, 0.35, seed);
+        for (auto bounds : vector<pair<int, int>>{{1, 1000}, {4, 1000}, {3, 4}}) {
+            CliqueSearchOptions options;
+            options.min_size = bounds.first;
+            options.max_size = bounds.second;
+            vector<set<int>> expected = sorted_copy(g.find_max_cliques(options));
+            for (int threads : {1, 3}) {
+                vector<set<int>> cliques;
+                CliqueSearchStats stats;
+                for_each_max_clique_sorted<TomitaPivot>(g, [&](const set<int>& clique) { cliques.push_back(clique); },
+                                                        threads, options, stats);
+                assert(stats.cliques == static_cast<long long>(cliques.size()));
+                assert(is_sorted(cliques.begin(), cliques.end()));
+                if (bounds.second < 1000) {
+                    // Truncated cliques depend on the search order; only check them for validity.
+                    for (const auto& clique : cliques) {
+                        assert(is_clique(g, clique) && static_cast<int>(clique.size()) <= bounds.second);
+                    }
+                } else {
+                    assert(cliques == expected);
+                }
+            }
+        }
+        cout << "G(80, 0.35) seed " << seed << ": Passed!" << endl;
+    }
+
+    // Test Case 2: Subproblems too large for their buffer are sorted through disk
+    {
+        Graph g = make_moon_moser_graph(8);
+        vector<set<int>> expected = sorted_copy(g.find_max_cliques());
+        for (int threads : {1, 4}) {
+            vector<set<int>> cliques;
+            CliqueSearchStats stats;
+            for_each_max_clique_sorted<TomitaPivot>(g, [&](const set<int>& clique) { cliques.push_back(clique); },
+                                                    threads, CliqueSearchOptions(), stats, TomitaPivot(), 0);
+            assert(cliques == expected);
+        }
+        cout << "External sort: Passed!" << endl;
+    }
+
+    // Test Case 3: Isolated vertices and the empty graph
+    {
+        Graph g(4);
+        g.add_edge(1, 2);
+        vector<set<int>> cliques;
+        CliqueSearchStats stats;
+        for_each_max_clique_sorted(g, [&](const set<int>& clique) { cliques.push_back(clique); }, 2,
+                                   CliqueSearchOptions(), stats);
+        assert(cliques == vector<set<int>>({{0}, {1, 2}, {3}}));
+        Graph empty(0);
+        for_each_max_clique_sorted(empty, [&](const set<int>&) { assert(false); }, 2, CliqueSearchOptions(), stats);
+        cout << "Small graphs: Passed!" << endl;
+    }
+
+    // Test Case 4: The buffered cliques are charged to the memory budget
+    {
+        Graph g = make_moon_moser_graph(8);
+        vector<set<int>> expected = sorted_copy(g.find_max_cliques());
+        for (int threads : {1, 3}) {
+            MemoryBudget unlimited;
+            CliqueSearchOptions options;
+            options.memory = &unlimited;
+            vector<set<int>> cliques;
+            CliqueSearchStats stats;
+            for_each_max_clique_sorted(g, [&](const set<int>& clique) { cliques.push_back(clique); }, threads,
+                                       options, stats);
+            assert(cliques == expected && unlimited.current() == 0);
+            // Each subproblem buffers thousands of cliques, more than its search's scratch sets.
+            assert(stats.memory_peak > size_t(64) << 10);
+
+            MemoryBudget budget(size_t(64) << 10);
+            options.memory = &budget;
+            cliques.clear();
+            for_each_max_clique_sorted(g, [&](const set<int>& clique) { cliques.push_back(clique); }, threads,
+                                       options, stats);
+            assert(stats.memory_exceeded && budget.current() == 0);
+            assert(cliques.size() < expected.size() && is_sorted(cliques.begin(), cliques.end()));
+            for (const auto& clique : cliques) {
+                assert(binary_search(expected.begin(), expected.end(), clique));
+            }
+        }
+        cout << "Memory budget: Passed!" << endl;
+    }
+
+    cout << "\nAll sorted output tests passed!" << endl;
+}
+
+void test_deterministic_output() {
+    cout << "\nRunning tests for deterministic parallel output..." << endl;
+
+    // Runs a search with options.deterministic and returns the cliques in the order reported.
+    auto run = [](auto search, int threads, CliqueSearchOptions options) {
+        options.deterministic = true;
+        vector<set<int>> cliques;
+        CliqueSearchStats stats;
+        search([&](const set<int>& clique) { cliques.push_back(clique); }, threads, options, stats);
+        assert(stats.cliques == static_cast<long long>(cliques.size()));
+        return cliques;
+    };
+    auto sorted_copy = [](vector<set<int>> cliques) {
+        sort(cliques.begin(), cliques.end());
+        return cliques;
+    };
+
+    // Test Case 1: Graph's parallel search reports the same sequence for any number of threads
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Graph g = make_random_graph(80, 0.4, seed);
+        for (int min_size : {1, 4}) {
+            CliqueSearchOptions options;
+            options.min_size = min_size;
+            auto tomita = [&](const CliqueCallback& emit, int threads, const CliqueSearchOptions& o,
+                              CliqueSearchStats& stats) {
+                g.for_each_max_clique_parallel<TomitaPivot>(emit, threads, o, stats);
+            };
+            auto random = [&](const CliqueCallback& emit, int threads, const CliqueSearchOptions& o,
+                              CliqueSearchStats& stats) {
+                g.for_each_max_clique_parallel(emit, threads, o, stats, RandomPivot(seed));
+            };
+            vector<set<int>> expected = run(tomita, 1, options);
+            assert(sorted_copy(expected) == sorted_copy(g.find_max_cliques(options)));
+            vector<set<int>> expected_random = run(random, 1, options);
+            assert(sorted_copy(expected_random) == sorted_copy(expected));
+            for (int threads : {2, 4}) {
+                assert(run(tomita, threads, options) == expected);
+                assert(run(random, threads, options) == expected_random);
+            }
+        }
+        cout << "Graph, G(80, 0.4) seed " << seed << ": Passed!" << endl;
+    }
+
+    // Test Case 2: The sparse engines report the sequence of their one-thread search
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Graph g = make_random_graph(120, 0.15, seed);
+        SparseCliqueEngine<RoaringBitmap> roaring(g);
+        SparseCliqueEngine<SortedVertexSet> sorted_sets(g);
+        PartitionCliqueEngine partition(g);
+        for (int min_size : {1, 3}) {
+            CliqueSearchOptions options;
+            options.min_size = min_size;
+            vector<set<int>> expected = sorted_copy(g.find_max_cliques(options));
+            auto check = [&](auto& engine) {
+                auto search = [&](const CliqueCallback& emit, int threads, const CliqueSearchOptions& o,
+                                  CliqueSearchStats& stats) { engine.for_each_max_clique(emit, o, stats, threads); };
+                vector<set<int>> serial = run(search, 1, options);
+                assert(sorted_copy(serial) == expected);
+                assert(run(search, 3, options) == serial);
+            };
+            check(roaring);
+            check(sorted_sets);
+            check(partition);
+        }
+        cout << "Sparse engines, G(120, 0.15) seed " << seed << ": Passed!" << endl;
+    }
+
+    // Test Case 3: Exceptions of either side of the reorder buffer reach the caller
+    {
+        auto throws = [](auto run) {
+            try {
+                run();
+            } catch (const runtime_error& e) {
+                return string(e.what()) == "write failed";
+            }
+            return false;
+        };
+        for (int threads : {1, 3}) {
+            vector<size_t> consumed;
+            assert(throws([&] {
+                run_in_order(100, threads, 8,
+                             [](size_t i, int) {
+                                 if (i == 40) throw runtime_error("write failed");
+                                 return i;
+                             },
+                             [&](size_t i) { consumed.push_back(i); });
+            }));
+            assert(consumed.size() <= 40);
+            for (size_t i = 0; i < consumed.size(); ++i) assert(consumed[i] == i);
+            assert(throws([&] {
+                run_in_order(100, threads, 8, [](size_t i, int) { return i; },
+                             [](size_t i) {
+                                 if (i == 10) throw runtime_error("write failed");
+                             });
+            }));
+        }
+        Graph g = make_random_graph(60, 0.4, 4);
+        CliqueSearchOptions options;
+        options.deterministic = true;
+        CliqueSearchStats stats;
+        CliqueCallback fail = [](const set<int>&) { throw runtime_error("write failed"); };
+        assert(throws([&] { g.for_each_max_clique_parallel(fail, 3, options, stats); }));
+        assert(throws([&] { for_each_max_clique_sorted(g, fail, 3, CliqueSearchOptions(), stats); }));
+        // The cliques buffered for output are released even though the callback threw before
+        // taking them.
+        MemoryBudget budget;
+        options.memory = &budget;
+        int taken = 0;
+        CliqueCallback fail_later = [&](const set<int>&) {
+            if (++taken == 5) throw runtime_error("write failed");
+        };
+        for (int threads : {1, 3}) {
+            taken = 0;
+            assert(throws([&] { g.for_each_max_clique_parallel(fail_later, threads, options, stats); }));
+            assert(budget.current() == 0);
+            taken = 0;
+            SparseCliqueEngine<RoaringBitmap> sparse(g);
+            assert(throws([&] { sparse.for_each_max_clique(fail_later, options, stats, threads); }));
+            assert(budget.current() == 0);
+            taken = 0;
+            PartitionCliqueEngine partition(g);
+            assert(throws([&] { partition.for_each_max_clique(fail_later, options, stats, threads); }));
+            assert(budget.current() == 0);
+        }
+        cout << "Exceptions: Passed!" << endl;
+    }
+
+    cout << "\nAll deterministic output tests passed!" << endl;
+}
+
+void test_local_subgraph() {
+    cout << "\nRunning tests for local subgraph extraction..." << endl;
+
+    // Checks every representation in 'local' against the graph.
+    auto check = [](const Graph& g, const LocalSubgraph& local, LocalSubgraph::Layout layout) {
+        int k = local.size();
+        long long edges = 0;
+        for (int i = 0; i < k; ++i) {
+            vector<int> expected;
+            for (int j = 0; j < k; ++j) {
+                bool adjacent = g.adj_matrix[local.vertices[i]][local.vertices[j]];
+                if (layout & LocalSubgraph::Bitset) assert(local.adjacent(i, j) == adjacent);
+                if (adjacent) expected.push_back(j);
+            }
+            if (layout & LocalSubgraph::Csr) {
+                assert(vector<int>(local.neighbors(i), local.neighbors(i) + local.degree(i)) == expected);
+            }
+            edges += expected.size();
+        }
+        assert(local.num_edges() == edges / 2);
+    };
+
+    // Test Case 1: Vertex lists in arbitrary order, in every layout, with buffers reused across calls
+    {
+        Graph g = make_random_graph(150, 0.2, 5);
+        CsrAdjacency adjacency(g);
+        LocalSubgraphExtractor extractor(adjacency);
+        LocalSubgraph local;
+        mt19937 rng(5);
+        for (int trial = 0; trial < 30; ++trial) {
+            vector<int> vertices(g.num_vertices);
+            for (int v = 0; v < g.num_vertices; ++v) vertices[v] = v;
+            shuffle(vertices.begin(), vertices.end(), rng);
+            vertices.resize(uniform_int_distribution<int>(0, 100)(rng));
+            for (auto layout : {LocalSubgraph::Bitset, LocalSubgraph::Csr, LocalSubgraph::Both}) {
+                extractor.extract(vertices, local, layout);
+                assert(local.vertices == vertices && local.num_later == local.size());
+                check(g, local, layout);
+            }
+        }
+        cout << "Induced subgraphs: Passed!" << endl;
+    }
+
+    // Test Case 2: Ego networks split into later and earlier neighbors
+    {
+        Graph g = make_random_graph(100, 0.3, 6);
+        CsrAdjacency adjacency(g);
+        LocalSubgraphExtractor extractor(adjacency);
+        LocalSubgraph local;
+        vector<int> position(g.num_vertices);
+        for (int v = 0; v < g.num_vertices; ++v) position[v] = (v * 37) % g.num_vertices;
+        for (const vector<int>& order : {vector<int>(), position}) {
+            for (int v = 0; v < g.num_vertices; ++v) {
+                extractor.extract_ego(v, order, local, LocalSubgraph::Both);
+                assert(local.size() == adjacency.degree(v));
+                for (int i = 0; i < local.size(); ++i) {
+                    int u = local.vertices[i];
+                    assert(g.adj_matrix[v][u]);
+                    bool later = order.empty() ? u > v : order[u] > order[v];
+                    assert(later == (i < local.num_later));
+                }
+                check(g, local, LocalSubgraph::Both);
+            }
+        }
+        cout << "Ego networks: Passed!" << endl;
+    }
+
+    // Test Case 3: A hub whose neighborhood is far longer than the list
+    {
+        int n = 2000;
+        vector<pair<int, int>> edges;
+        for (int v = 1; v < n; ++v) edges.push_back({0, v});
+        for (int v = 1; v + 1 < n; v += 2) edges.push_back({v, v + 1});
+        CsrAdjacency adjacency(n, edges);
+        LocalSubgraphExtractor extractor(adjacency);
+        LocalSubgraph local;
+        extractor.extract({5, 0, 6, 7, 1999}, local, LocalSubgraph::Both);
+        assert(local.num_edges() == 5);
+        assert(local.adjacent(1, 0) && local.adjacent(0, 2) && !local.adjacent(2, 3) && local.adjacent(1, 4));
+        assert(local.degree(1) == 4 && local.degree(3) == 1);
+        extractor.extract_ego(0, {}, local);
+        assert(local.size() == n - 1 && local.num_later == n - 1 && local.num_edges() == (n - 1) / 2);
+        cout << "Hub: Passed!" << endl;
+    }
+
+    // Test Case 4: Edge lists with self-loops and parallel edges give the same CSR as the graph
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Graph g = make_random_graph(70, 0.2, seed);
+        vector<pair<int, int>> edges;
+        for (int u = 0; u < g.num_vertices; ++u) {
+            edges.push_back({u, u});
+            for (int v = 0; v < g.num_vertices; ++v) {
+                if (g.adj_matrix[u][v]) edges.push_back({v, u});
+            }
+        }
+        CsrAdjacency from_edges(g.num_vertices, edges), from_graph(g);
+        assert(from_edges.offsets == from_graph.offsets && from_edges.targets == from_graph.targets);
+        cout << "CSR from edges, seed " << seed << ": Passed!" << endl;
+    }
+
+    cout << "\nAll local subgraph tests passed!" << endl;
+}
+
+void test_edge_support() {
+    cout << "\nRunning tests for edge support and truss filtering..." << endl;
+
+    auto sorted_copy = [](vector<set<int>> cliques) {
+        sort(cliques.begin(), cliques.end());
+        return cliques;
+    };
+
+    // Test Case 1: Supports and triangle counts match a brute-force count, for any number of threads
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Graph g = make_random_graph(90, 0.1 * seed, seed);
+        for (int threads : {1, 3}) {
+            EdgeSupport support(g, threads);
+            long long triangles = 0;
+            vector<long long> through(g.num_vertices, 0);
+            for (int u = 0; u < g.num_vertices; ++u) {
+                for (int v = 0; v < g.num_vertices; ++v) {
+                    if (u == v || !g.adj_matrix[u][v]) {
+                        assert(support.support(u, v) == -1);
+                        continue;
+                    }
+                    int common = 0;
+                    for (int w = 0; w < g.num_vertices; ++w) common += g.adj_matrix[u][w] && g.adj_matrix[v][w];
+                    assert(support.support(u, v) == common);
+                    through[u] += common;
+                    triangles += common;
+                }
+                through[u] /= 2;
+            }
+            assert(support.num_triangles() == triangles / 6);
+            assert(support.vertex_triangles() == through);
+        }
+        cout << "Supports, G(90, " << 0.1 * seed << "): Passed!" << endl;
+    }
+
+    // Test Case 2: The k-truss matches peeling by recounting until nothing changes
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Graph g = make_random_graph(60, 0.3, seed);
+        EdgeSupport support(g);
+        for (int k : {2, 3, 4, 5, 6}) {
+            Graph peeled = g;
+            for (bool changed = true; changed;) {
+                changed = false;
+                for (int u = 0; u < g.num_vertices; ++u) {
+                    for (int v = u + 1; v < g.num_vertices; ++v) {
+                        if (!peeled.adj_matrix[u][v]) continue;
+                        int common = 0;
+                        for (int w = 0; w < g.num_vertices; ++w) {
+                            common += peeled.adj_matrix[u][w] && peeled.adj_matrix[v][w];
+                        }
+                        if (common < k - 2) {
+                            peeled.remove_edge(u, v);
+                            changed = true;
+                        }
+                    }
+                }
+            }
+            vector<pair<int, int>> expected;
+            for (int u = 0; u < g.num_vertices; ++u) {
+                for (int v = u + 1; v < g.num_vertices; ++v) {
+                    if (peeled.adj_matrix[u][v]) expected.push_back({u, v});
+                }
+            }
+            assert(support.truss_edges(k) == expected);
+        }
+        cout << "Truss, G(60, 0.3) seed " << seed << ": Passed!" << endl;
+    }
+
+    // Test Case 3: The pruned search reports the cliques of Graph's search, with either pivot
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        Graph g = make_random_graph(80, 0.08 * seed, seed);
+        g.add_edge(0, 1);
+        for (int v = 0; v < g.num_vertices; ++v) {
+            if (v != 2 && g.adj_matrix[2][v]) g.remove_edge(2, v);
+        }
+        EdgeSupport support(g, 2);
+        for (auto bounds : vector<pair<int, int>>{{1, 1000}, {2, 1000}, {3, 1000}, {4, 1000}, {1, 2}}) {
+            CliqueSearchOptions options;
+            options.min_size = bounds.first;
+            options.max_size = bounds.second;
+            // Truncated cliques depend on the search order; the rest must match exactly.
+            auto exact = [&](const vector<set<int>>& cliques) {
+                vector<set<int>> result;
+                for (const auto& clique : cliques) {
+                    assert(is_clique(g, clique) && static_cast<int>(clique.size()) <= options.max_size);
+                    if (static_cast<int>(clique.size()) < options.max_size) result.push_back(clique);
+                }
+                return sorted_copy(result);
+            };
+            vector<set<int>> expected = exact(g.find_max_cliques(options));
+            for (int threads : {1, 3}) {
+                vector<set<int>> cliques, by_triangles;
+                CliqueSearchStats stats;
+                support.for_each_max_clique([&](const set<int>& clique) { cliques.push_back(clique); }, threads,
+                                            options, stats);
+                assert(stats.cliques == static_cast<long long>(cliques.size()));
+                assert(exact(cliques) == expected);
+                support.for_each_max_clique([&](const set<int>& clique) { by_triangles.push_back(clique); },
+                                            threads, options, stats, support.triangle_pivot());
+                assert(exact(by_triangles) == expected);
+            }
+        }
+        cout << "Pruned search, G(80, " << 0.08 * seed << "): Passed!" << endl;
+    }
+
+    cout << "\nAll edge support tests passed!" << endl;
+}
+
+void test_graph_io() {
+    cout << "\nRunning tests for graph file formats..." << endl;
+
+    // The house graph in every supported format.
+    const vector<set<int>> expected = {{0, 1, 4}, {1, 2}, {2, 3}, {0, 3}};
+    auto check = [&](const string& test_name, const string& text, GraphFormat format) {
+        istringstream in(text);
+        Graph g = read_graph(in, format);
+        vector<set<int>> actual = g.find_max_cliques();
+        vector<set<int>> sorted_expected = expected;
+        sort(actual.begin(), actual.end());
+        sort(sorted_expected.begin(), sorted_expected.end());
+        assert(g.num_vertices == 5 && actual == sorted_expected);
+        cout << test_name << ": Passed!" << endl;
+    };
+    check("Edge list", "# house\n0 1\n1 2\n2 3\n3 0\n0 4\n1 4 0.5\n4 4\n", GraphFormat::EdgeList);
+    check("DIMACS", "c house\np edge 5 6\ne 1 2\ne 2 3\ne 3 4\ne 4 1\ne 1 5\ne 2 5\n", GraphFormat::Dimacs);
+    check("METIS", "% house\n5 6\n2 4 5\n1 3 5\n2 4\n1 3\n1 2\n", GraphFormat::Metis);
+    check("Matrix Market", "%%MatrixMarket matrix coordinate pattern symmetric\n5 5 6\n2 1\n3 2\n4 3\n4 1\n5 1\n5 2\n",
+          GraphFormat::MatrixMarket);
+
+    // Malformed inputs are rejected with an exception.
+    for (const auto& bad : vector<pair<string, GraphFormat>>{{"0 x\n", GraphFormat::EdgeList},
+                                                             {"e 1 2\n", GraphFormat::Dimacs},
+                                                             {"p edge 2 1\ne 1 3\n", GraphFormat::Dimacs},
+                                                             {"2 1\n3\n", GraphFormat::Metis}}) {
+        istringstream in(bad.first);
+        bool thrown = false;
+        try {
+            read_graph(in, bad.second);
+        } catch (const runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    cout << "Malformed inputs: Passed!" << endl;
+
+    GraphFormat format;
+    assert(graph_format_for_path("a/b.clq") == GraphFormat::Dimacs);
+    assert(graph_format_for_path("b.graph") == GraphFormat::Metis);
+    assert(graph_format_for_path("b.mtx") == GraphFormat::MatrixMarket);
+    assert(graph_format_for_path("b.txt") == GraphFormat::EdgeList);
+    assert(parse_graph_format("metis", format) && format == GraphFormat::Metis);
+    assert(!parse_graph_format("gml", format));
+    cout << "Format names: Passed!" << endl;
+
+    cout << "\nAll graph file format tests passed!" << endl;
+}
+
+void test_alpha_max_cliques() {
+    cout << "\nRunning tests for find_alpha_max_cliques..." << endl;
+
+    auto run_test = [](const string& test_name, const ProbabilisticGraph& g, double alpha,
+                       vector<set<int>> expected_cliques) {
+        cout << "--- Test Case: " << test_name << " ---" << endl;
+        vector<set<int>> actual_cliques = g.find_alpha_max_cliques(alpha);
+        sort(expected_cliques.begin(), expected_cliques.end());
+        sort(actual_cliques.begin(), actual_cliques.end());
+        assert(actual_cliques == expected_cliques);
+        for (const auto& clique : actual_cliques) {
+            assert(g.clique_probability(clique) >= alpha);
+        }
+        cout << test_name << ": Passed!" << endl;
+    };
+
+    // Test Case 1: Certain edges behave like the deterministic graph
+    {
+        ProbabilisticGraph g(4);
+        g.add_edge(0, 1, 1.0); g.add_edge(1, 2, 1.0); g.add_edge(0, 2, 1.0); g.add_edge(2, 3, 1.0);
+        run_test("Certain Edges", g, 1.0, {{0, 1, 2}, {2, 3}});
+    }
+
+    // Test Case 2: Triangle whose product falls below alpha splits into its likely edges
+    {
+        ProbabilisticGraph g(3);
+        g.add_edge(0, 1, 0.9); g.add_edge(1, 2, 0.8); g.add_edge(0, 2, 0.5);
+        run_test("Triangle, alpha = 0.3", g, 0.3, {{0, 1, 2}});
+        run_test("Triangle, alpha = 0.6", g, 0.6, {{0, 1}, {1, 2}});
+        run_test("Triangle, alpha = 0.85", g, 0.85, {{0, 1}, {2}});
+    }
+
+    // Test Case 3: Low-probability edges are pruned while the likely K4 survives
+    {
+        ProbabilisticGraph g(5);
+        for (int i = 0; i < 4; ++i) {
+            for (int j = i + 1; j < 4; ++j) {
+                g.add_edge(i, j, 0.95);
+            }
+        }
+        g.add_edge(3, 4, 0.1);
+        run_test("K4 + Weak Pendant", g, 0.5, {{0, 1, 2, 3}, {4}});
+        run_test("K4 + Weak Pendant, alpha = 0.05", g, 0.05, {{0, 1, 2, 3}, {3, 4}});
+    }
+
+    cout << "\nAll alpha-maximal clique tests passed!" << endl;
+}
+
+void test_temporal_cliques() {
+    cout << "\nRunning tests for temporal cliques..." << endl;
+
+    auto check = [](const string& test_name, vector<set<int>> actual, vector<set<int>> expected) {
+        cout << "--- Test Case: " << test_name << " ---" << endl;
+        sort(expected.begin(), expected.end());
+        sort(actual.begin(), actual.end());
+        assert(actual == expected);
+        cout << test_name << ": Passed!" << endl;
+    };
+
+    // Test Case 1: Triangle forms only once all three edges are inside the window
+    {
+        TemporalGraph tg(4);
+        tg.add_edge(0, 1, 1);
+        tg.add_edge(1, 2, 2);
+        tg.add_edge(0, 2, 3);
+        tg.add_edge(2, 3, 5);
+        check("Window [1, 3)", tg.find_max_cliques_in_window(1, 3), {{0, 1}, {1, 2}, {3}});
+        check("Window [1, 4)", tg.find_max_cliques_in_window(1, 4), {{0, 1, 2}, {3}});
+        check("Window [2, 6)", tg.find_max_cliques_in_window(2, 6), {{0, 2}, {1, 2}, {2, 3}});
+    }
+
+    // Test Case 2: Sliding window matches a full rebuild at every step
+    {
+        TemporalGraph tg(6);
+        int events[][3] = {{0, 1, 0}, {1, 2, 1}, {0, 2, 2}, {3, 4, 3}, {2, 3, 4}, {4, 5, 5},
+                           {3, 5, 6}, {0, 1, 7}, {2, 4, 8}, {2, 3, 9}, {1, 2, 10}, {0, 5, 11}};
+        for (auto& e : events) tg.add_edge(e[0], e[1], e[2]);
+        SlidingWindowCliques window(tg, 0, 4);
+        check("Slide start [0, 4)", window.cliques(), tg.find_max_cliques_in_window(0, 4));
+        for (int step = 1; step <= 10; ++step) {
+            window.slide(1);
+            check("Slide to [" + to_string(window.begin()) + ", " + to_string(window.end()) + ")",
+                  window.cliques(), tg.find_max_cliques_in_window(window.begin(), window.end()));
+        }
+        window.slide_to(2, 12);
+        check("Slide back to [2, 12)", window.cliques(), tg.find_max_cliques_in_window(2, 12));
+    }
+
+    // Test Case 3: Delta-cliques keep only pairs that interact at least every delta time units
+    {
+        TemporalGraph tg(4);
+        for (int t = 0; t <= 10; t += 2) {
+            tg.add_edge(0, 1, t);
+            tg.add_edge(1, 2, t + 1);
+            tg.add_edge(0, 2, t);
+        }
+        tg.add_edge(2, 3, 0);
+        tg.add_edge(2, 3, 10);
+        check("Delta = 2 over [0, 10]", tg.find_delta_cliques(0, 10, 2), {{0, 1, 2}, {3}});
+        check("Delta = 10 over [0, 10]", tg.find_delta_cliques(0, 10, 10), {{0, 1, 2}, {2, 3}});
+        check("Delta = 1 over [0, 10]", tg.find_delta_cliques(0, 10, 1), {{0}, {1}, {2}, {3}});
+    }
+
+    // Test Case 4: Events stay sorted by time, in arrival order among equal times
+    {
+        TemporalGraph tg(4);
+        int events[][3] = {{0, 1, 5}, {1, 2, 1}, {2, 3, 5}, {0, 3, 3}, {3, 1, 5}, {0, 2, 0}, {1, 3, 7}};
+        for (auto& e : events) tg.add_edge(e[0], e[1], e[2]);
+        vector<vector<long long>> actual;
+        for (const auto& e : tg.edges) actual.push_back({e.u, e.v, e.time});
+        assert(actual == vector<vector<long long>>(
+                             {{0, 2, 0}, {1, 2, 1}, {0, 3, 3}, {0, 1, 5}, {2, 3, 5}, {1, 3, 5}, {1, 3, 7}}));
+        cout << "Out-of-order events: Passed!" << endl;
+    }
+
+    cout << "\nAll temporal clique tests passed!" << endl;
+}
+
+int main() {
+    test_find_max_cliques();
+    test_size_bounded_cliques();
+    test_vertex_orderings();
+    test_pivot_policies();
+    test_clique_count_estimate();
+    test_progress_reporting();
+    test_phase_profiler();
+    test_streaming_and_parallel();
+    test_graph_io();
+    test_cliques_containing_vertex();
+    test_clique_cache();
+    test_twin_reduction();
+    test_clique_families();
+    test_roaring_bitmap();
+    test_sparse_engine();
+    test_intersection_kernels();
+    test_partition_engine();
+    test_memory_budget();
+    test_clique_store();
+    test_sorted_output();
+    test_deterministic_output();
+    test_local_subgraph();
+    test_edge_support();
+    test_alpha_max_cliques();
+    test_temporal_cliques();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,2226 @@
+#ifndef BRON_KERBOSCH_H
+#define BRON_KERBOSCH_H
+
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <cstdint>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <ostream>
+#include <queue>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Order in which a subproblem branches on the vertices of P \ N(pivot).
+enum class VertexOrdering {
+    VertexId,          // Ascending vertex id, the order of std::set<int>.
+    DegreeDescending,  // High global degree first.
+    DegreeAscending,   // Low global degree first.
+    CoreAscending,     // Low core number first (degeneracy order).
+    ColorDescending,   // Highest greedy color class of P first, as in Tomita's MCQ.
+};
+
+// Snapshot of a running search, delivered to progress callbacks.
+struct CliqueSearchProgress {
+    // Top-level subproblems (branches of the root) completed, out of the total.
+    int top_level_done = 0;
+    int top_level_total = 0;
+    long long cliques = 0;
+    long long nodes = 0;
+    double elapsed_seconds = 0;
+    double nodes_per_second = 0;
+    double cliques_per_second = 0;
+    // Estimated time remaining, or -1 until the first top-level subproblem has completed.
+    double eta_seconds = -1;
+    // True for the last update of a search.
+    bool finished = false;
+};
+
+class ProgressMonitor {
+public:
+    // Counters bumped by the search with relaxed atomic increments; read by the reporting thread.
+    std::atomic<long long> nodes{0};
+    std::atomic<long long> cliques{0};
+    std::atomic<int> top_level_done{0};
+    // Random paths sampled per top-level subproblem to weight the ETA; 0 weights them all equally.
+    int estimate_samples;
+
+    /**
+     * @brief Constructor for the ProgressMonitor class.
+     * @param callback Called from a background thread every 'interval' while a search runs, and once
+     *                 more from the searching thread when it finishes.
+     * @param interval The time between two updates.
+     * @param estimate_samples The number of paths sampled per top-level subproblem to estimate its size.
+     */
+    ProgressMonitor(std::function<void(const CliqueSearchProgress&)> callback,
+                    std::chrono::milliseconds interval = std::chrono::milliseconds(1000), int estimate_samples = 4)
+        : estimate_samples(estimate_samples), callback(std::move(callback)), interval(interval) {}
+
+    ProgressMonitor(const ProgressMonitor&) = delete;
+    ProgressMonitor& operator=(const ProgressMonitor&) = delete;
+
+    ~ProgressMonitor() {
+        stop_reporter();
+    }
+
+    /**
+     * @brief Starts reporting a search whose root has one top-level subproblem per weight.
+     * @param weights The estimated relative size of each top-level subproblem, in branching order.
+     */
+    void begin(const std::vector<double>& weights) {
+        stop_reporter();
+        cumulative_weight.assign(1, 0.0);
+        for (double w : weights) {
+            cumulative_weight.push_back(cumulative_weight.back() + w);
+        }
+        stopping = false;
+        reporter = std::thread([this] {
+            std::unique_lock<std::mutex> lock(reporter_mutex);
+            while (!reporter_cv.wait_for(lock, interval, [this] { return stopping; })) {
+                this->callback(snapshot());
+            }
+        });
+    }
+
+    /**
+     * @brief Clears the counters before a new search.
+     */
+    void reset() {
+        stop_reporter();
+        nodes.store(0, std::memory_order_relaxed);
+        cliques.store(0, std::memory_order_relaxed);
+        top_level_done.store(0, std::memory_order_relaxed);
+        cumulative_weight.assign(1, 0.0);
+        start_time = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * @brief Stops the reporting thread, if any, and delivers the final update of the search.
+     */
+    void finish() {
+        stop_reporter();
+        CliqueSearchProgress progress = snapshot();
+        progress.finished = true;
+        progress.eta_seconds = 0;
+        callback(progress);
+    }
+
+    /**
+     * @brief Returns the current progress of the search.
+     */
+    CliqueSearchProgress snapshot() const {
+        CliqueSearchProgress progress;
+        progress.top_level_total = static_cast<int>(cumulative_weight.size()) - 1;
+        progress.top_level_done = std::min(top_level_done.load(std::memory_order_relaxed), progress.top_level_total);
+        progress.nodes = nodes.load(std::memory_order_relaxed);
+        progress.cliques = cliques.load(std::memory_order_relaxed);
+        progress.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        if (progress.elapsed_seconds > 0) {
+            progress.nodes_per_second = progress.nodes / progress.elapsed_seconds;
+            progress.cliques_per_second = progress.cliques / progress.elapsed_seconds;
+        }
+        if (progress.top_level_total >= 0) {
+            // Top-level subproblems complete in branching order, so the finished work is a prefix.
+            double done = cumulative_weight[progress.top_level_done];
+            double total = cumulative_weight.back();
+            if (done > 0) {
+                progress.eta_seconds = progress.elapsed_seconds * (total - done) / done;
+            }
+        }
+        return progress;
+    }
+
+private:
+    std::function<void(const CliqueSearchProgress&)> callback;
+    std::chrono::milliseconds interval;
+    std::vector<double> cumulative_weight = {0.0};
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    bool stopping = false;
+    std::thread reporter;
+    std::mutex reporter_mutex;
+    std::condition_variable reporter_cv;
+
+    void stop_reporter() {
+        if (!reporter.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(reporter_mutex);
+            stopping = true;
+        }
+        reporter_cv.notify_all();
+        reporter.join();
+    }
+};
+
+// Phases of a search step that the profiler attributes time to.
+enum class SearchPhase {
+    Pivot,         // Pivot selection and building P \ N(pivot).
+    Intersection,  // Building the child P and X.
+    Output,        // Reporting a clique.
+    Allocation,    // Copying R for the child.
+    Count,
+};
+
+// Accumulates per-phase timings and a bounded list of trace events. Not thread-safe: parallel
+// searches give every worker its own profiler (see WorkerOptions) and merge them after the join.
+class PhaseProfiler {
+public:
+    /**
+     * @brief Constructor for the PhaseProfiler class.
+     * @param max_trace_events The number of individual phase events kept for the trace; totals are
+     *                         always accumulated for every event.
+     */
+    explicit PhaseProfiler(size_t max_trace_events = 100000)
+        : max_trace_events(max_trace_events), start_ticks(ticks()), start_time(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief Reads the cycle counter (rdtsc on x86, steady_clock nanoseconds elsewhere).
+     */
+    static uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /**
+     * @brief Records one occurrence of a phase that ran from tick 'begin' to tick 'end'.
+     */
+    void record(SearchPhase phase, uint64_t begin, uint64_t end) {
+        size_t i = static_cast<size_t>(phase);
+        total_ticks[i] += end - begin;
+        calls[i]++;
+        if (events.size() < max_trace_events) {
+            events.push_back({phase, begin, end, 1});
+        }
+    }
+
+    /**
+     * @brief Adds the totals and events of another profiler, e.g. a worker's, to this one.
+     * @param other The profiler to merge.
+     * @param thread The trace thread id of the other profiler's events.
+     */
+    void merge(const PhaseProfiler& other, int thread) {
+        for (size_t i = 0; i < static_cast<size_t>(SearchPhase::Count); ++i) {
+            total_ticks[i] += other.total_ticks[i];
+            calls[i] += other.calls[i];
+        }
+        for (const Event& e : other.events) {
+            if (events.size() == max_trace_events) break;
+            events.push_back({e.phase, e.begin, e.end, thread});
+        }
+    }
+
+    /**
+     * @brief Returns the number of individual events kept for the trace.
+     */
+    size_t trace_capacity() const {
+        return max_trace_events;
+    }
+
+    /**
+     * @brief Returns the ticks spent in a phase, summed over all its occurrences.
+     */
+    uint64_t phase_ticks(SearchPhase phase) const {
+        return total_ticks[static_cast<size_t>(phase)];
+    }
+
+    /**
+     * @brief Returns the number of recorded occurrences of a phase.
+     */
+    long long phase_calls(SearchPhase phase) const {
+        return calls[static_cast<size_t>(phase)];
+    }
+
+    static const char* phase_name(SearchPhase phase) {
+        static const char* names[] = {"pivot", "intersection", "output", "allocation"};
+        return names[static_cast<size_t>(phase)];
+    }
+
+    /**
+     * @brief Writes the recorded events in the Chrome trace event format, which chrome://tracing and
+     *        Perfetto open directly. Ticks are converted to microseconds with the tick rate measured
+     *        over the profiler's lifetime; per-phase totals are attached as metadata.
+     */
+    void write_chrome_trace(std::ostream& out) const {
+        double elapsed_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start_time).count();
+        double ticks_per_us = elapsed_us > 0 ? (ticks() - start_ticks) / elapsed_us : 1.0;
+        if (ticks_per_us <= 0) ticks_per_us = 1.0;
+        out << "{\"traceEvents\":[";
+        for (size_t i = 0; i < events.size(); ++i) {
+            const Event& e = events[i];
+            out << (i ? "," : "") << "{\"name\":\"" << phase_name(e.phase) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+                << ",\"ts\":" << (e.begin - start_ticks) / ticks_per_us
+                << ",\"dur\":" << (e.end - e.begin) / ticks_per_us << "}";
+        }
+        out << "],\"otherData\":{";
+        for (size_t i = 0; i < static_cast<size_t>(SearchPhase::Count); ++i) {
+            out << (i ? "," : "") << "\"" << phase_name(static_cast<SearchPhase>(i)) << "_us\":"
+                << total_ticks[i] / ticks_per_us << ",\"" << phase_name(static_cast<SearchPhase>(i))
+                << "_calls\":" << calls[i];
+        }
+        out << "}}" << std::endl;
+    }
+
+private:
+    struct Event {
+        SearchPhase phase;
+        uint64_t begin;
+        uint64_t end;
+        int thread;
+    };
+
+    size_t max_trace_events;
+    uint64_t start_ticks;
+    std::chrono::steady_clock::time_point start_time;
+    uint64_t total_ticks[static_cast<size_t>(SearchPhase::Count)] = {};
+    long long calls[static_cast<size_t>(SearchPhase::Count)] = {};
+    std::vector<Event> events;
+};
+
+// Times the enclosing scope as one occurrence of a phase; a null profiler makes it a no-op.
+class ScopedPhaseTimer {
+public:
+    ScopedPhaseTimer(PhaseProfiler* profiler, SearchPhase phase)
+        : profiler(profiler), phase(phase), begin(profiler ? PhaseProfiler::ticks() : 0) {}
+
+    ~ScopedPhaseTimer() {
+        if (profiler) {
+            profiler->record(phase, begin, PhaseProfiler::ticks());
+        }
+    }
+
+private:
+    PhaseProfiler* profiler;
+    SearchPhase phase;
+    uint64_t begin;
+};
+
+/**
+ * @brief Tracks the memory held by searches against an optional hard limit.
+ * @brief The engines charge their scratch sets and collected output as they allocate them and
+ *        release them when they are freed, so current() is the tracked memory in use and peak() its
+ *        high-water mark. Several searches, on any number of threads, may share one budget. Once a
+ *        charge takes the usage past the limit, on_exceeded is called, if set. It may free memory,
+ *        e.g. by spilling output to disk, and return true to let the search go on. Otherwise the
+ *        budget is marked exceeded and every search using it stops, keeping the results so far.
+ */
+class MemoryBudget {
+public:
+    /**
+     * @brief Constructor for the MemoryBudget class.
+     * @param limit The hard limit in bytes; the default never triggers.
+     */
+    explicit MemoryBudget(size_t limit = SIZE_MAX) : limit_bytes(limit) {}
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    // Called under a lock when the limit is crossed; returns whether the searches may continue.
+    std::function<bool(MemoryBudget&)> on_exceeded;
+
+    /**
+     * @brief Adds 'bytes' to the usage. The bytes count even when the charge fails, so every charge
+     *        is paired with a release of the same size.
+     * @return False if the budget is or becomes exceeded.
+     */
+    bool charge(size_t bytes) {
+        size_t now = used.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        size_t high = high_water.load(std::memory_order_relaxed);
+        while (now > high && !high_water.compare_exchange_weak(high, now, std::memory_order_relaxed)) {
+        }
+        if (now <= limit_bytes) {
+            return !stopped.load(std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> lock(exceeded_mutex);
+        if (stopped.load(std::memory_order_relaxed)) return false;
+        // Another thread's handler may already have made room.
+        if (used.load(std::memory_order_relaxed) <= limit_bytes) return true;
+        if (on_exceeded && on_exceeded(*this) && used.load(std::memory_order_relaxed) <= limit_bytes) {
+            return true;
+        }
+        stopped.store(true, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * @brief Subtracts 'bytes' from the usage.
+     */
+    void release(size_t bytes) {
+        used.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    size_t current() const {
+        return used.load(std::memory_order_relaxed);
+    }
+
+    size_t peak() const {
+        return high_water.load(std::memory_order_relaxed);
+    }
+
+    size_t limit() const {
+        return limit_bytes;
+    }
+
+    /**
+     * @brief Returns whether the limit was crossed and not recovered from by on_exceeded.
+     */
+    bool exceeded() const {
+        return stopped.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Clears the exceeded flag and restarts the peak from the current usage.
+     */
+    void reset() {
+        stopped.store(false, std::memory_order_relaxed);
+        high_water.store(current(), std::memory_order_relaxed);
+    }
+
+private:
+    size_t limit_bytes;
+    std::atomic<size_t> used{0};
+    std::atomic<size_t> high_water{0};
+    std::atomic<bool> stopped{false};
+    std::mutex exceeded_mutex;
+};
+
+// Charges a budget for the lifetime of the enclosing scope; a null budget makes it a no-op.
+class ScopedMemoryCharge {
+public:
+    ScopedMemoryCharge(MemoryBudget* budget, size_t bytes)
+        : budget(budget), bytes(bytes), within_budget(!budget || budget->charge(bytes)) {}
+
+    ~ScopedMemoryCharge() {
+        if (budget) {
+            budget->release(bytes);
+        }
+    }
+
+    ScopedMemoryCharge(const ScopedMemoryCharge&) = delete;
+    ScopedMemoryCharge& operator=(const ScopedMemoryCharge&) = delete;
+
+    bool ok() const {
+        return within_budget;
+    }
+
+private:
+    MemoryBudget* budget;
+    size_t bytes;
+    bool within_budget;
+};
+
+// Estimated heap footprint of a std::set<int>: the header plus one red-black tree node (color,
+// three links and the value, padded) per element.
+inline size_t set_memory_bytes(const std::set<int>& s) {
+    return sizeof(s) + s.size() * 5 * sizeof(void*);
+}
+
+// The search only contains phase timers when built with -DBK_PROFILE, so default builds pay nothing.
+#ifdef BK_PROFILE
+#define BK_PROFILE_SCOPE(profiler, phase) ScopedPhaseTimer bk_phase_timer((profiler), (phase))
+#else
+#define BK_PROFILE_SCOPE(profiler, phase) ((void)0)
+#endif
+
+struct CliqueSearchOptions {
+    // Only cliques with at least this many vertices are reported.
+    int min_size = 1;
+    // Cliques that reach this many vertices are reported as they are, without being extended further.
+    int max_size = std::numeric_limits<int>::max();
+    // Subproblems with |R| <= coloring_depth recolor P greedily and prune when |R| + colors(P) < min_size;
+    // deeper subproblems reuse the inherited coloring restricted to their P. Negative disables the bound.
+    int coloring_depth = -1;
+    VertexOrdering ordering = VertexOrdering::VertexId;
+    // Receives progress updates while the search runs, if set. Must outlive the search.
+    ProgressMonitor* progress = nullptr;
+    // Receives per-phase timings if set; only used in builds with -DBK_PROFILE. Parallel searches
+    // time every worker on its own profiler and merge them into this one when they finish.
+    PhaseProfiler* profiler = nullptr;
+    // Charged with the search's scratch and collected output if set; when it is exceeded the search
+    // stops and keeps the cliques found so far. Must outlive the search.
+    MemoryBudget* memory = nullptr;
+    // Parallel searches report the cliques in the same order for any number of threads: the cliques
+    // of every top-level subproblem are buffered and passed on in the order of the subproblems.
+    bool deterministic = false;
+};
+
+// Instrumentation counters filled in by a search.
+struct CliqueSearchStats {
+    // Recursive calls, i.e. nodes of the search tree.
+    long long nodes = 0;
+    // Cliques reported.
+    long long cliques = 0;
+    // Subproblems cut off by the size or coloring bounds.
+    long long pruned = 0;
+    // Largest |R| seen in the search tree.
+    int max_depth = 0;
+    // Tracked bytes still held when the search returned (the collected output), and the most held
+    // at any time. With a shared MemoryBudget these cover everything charged to it.
+    size_t memory_current = 0;
+    size_t memory_peak = 0;
+    // Whether the search stopped early because its MemoryBudget was exceeded.
+    bool memory_exceeded = false;
+};
+
+// Copies the usage of the budget of a finished search into its stats.
+inline void record_memory_stats(const MemoryBudget& memory, CliqueSearchStats& stats) {
+    stats.memory_current = memory.current();
+    stats.memory_peak = memory.peak();
+    stats.memory_exceeded = memory.exceeded();
+}
+
+// The options of every worker of a parallel search: copies of the search's options, each with its
+// own PhaseProfiler if one is attached, since a profiler is not thread-safe. When destroyed, after
+// the workers have joined, it merges worker id's profile into the search's profiler as trace thread
+// id + 1.
+class WorkerOptions {
+public:
+    WorkerOptions(const CliqueSearchOptions& options, int num_threads) : workers(num_threads, options) {
+        if (options.profiler) {
+            target = options.profiler;
+            profilers.reserve(num_threads);
+            for (int id = 0; id < num_threads; ++id) {
+                profilers.emplace_back(target->trace_capacity());
+                workers[id].profiler = &profilers[id];
+            }
+        }
+    }
+
+    ~WorkerOptions() {
+        for (size_t id = 0; id < profilers.size(); ++id) {
+            target->merge(profilers[id], static_cast<int>(id) + 1);
+        }
+    }
+
+    WorkerOptions(const WorkerOptions&) = delete;
+    WorkerOptions& operator=(const WorkerOptions&) = delete;
+
+    const CliqueSearchOptions& operator[](int id) const {
+        return workers[id];
+    }
+
+private:
+    std::vector<CliqueSearchOptions> workers;
+    std::vector<PhaseProfiler> profilers;
+    PhaseProfiler* target = nullptr;
+};
+
+/**
+ * @brief Solves numbered subproblems on worker threads and hands their results to the calling thread
+ *        in order of number: a streaming reorder buffer.
+ * @brief Workers take the subproblems in increasing order, but never more than 'window' past the
+ *        first result not yet consumed, so at most 'window' results are held at a time. The calling
+ *        thread consumes every result as soon as all earlier ones have been consumed, while the
+ *        workers go on with the later subproblems.
+ * @param count The number of subproblems.
+ * @param num_threads The number of worker threads; 1 or less solves the subproblems on the calling thread.
+ * @param window The most subproblems solved ahead of the output.
+ * @param solve Called as solve(i, worker) on the worker thread numbered 'worker' (0 on the calling
+ *              thread); returns the result of subproblem i, which must be default-constructible.
+ * @param consume Called as consume(result) on the calling thread, in increasing order of subproblem.
+ * @note If solve or consume throws, no more subproblems are started or consumed; the workers are
+ *       joined and the first exception is rethrown on the calling thread.
+ */
+template <typename Solve, typename Consume>
+void run_in_order(size_t count, int num_threads, size_t window, Solve solve, Consume consume) {
+    using Result = decltype(solve(size_t(0), 0));
+    if (num_threads <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            consume(solve(i, 0));
+        }
+        return;
+    }
+    std::vector<Result> results(count);
+    std::vector<char> ready(count, 0);
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t next_solve = 0, next_consume = 0;
+    // The first exception of solve or consume; once set, everyone stops.
+    std::exception_ptr error;
+    auto fail = [&] {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) error = std::current_exception();
+        }
+        changed.notify_all();
+    };
+    auto worker = [&](int id) {
+        try {
+            for (;;) {
+                size_t i;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&] {
+                        return error || next_solve >= count || next_solve < next_consume + window;
+                    });
+                    if (error || next_solve >= count) break;
+                    i = next_solve++;
+                }
+                Result result = solve(i, id);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    results[i] = std::move(result);
+                    ready[i] = 1;
+                }
+                changed.notify_all();
+            }
+        } catch (...) {
+            fail();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int id = 0; id < num_threads; ++id) {
+        threads.emplace_back(worker, id);
+    }
+    try {
+        for (size_t i = 0; i < count; ++i) {
+            Result result;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return error || ready[i] != 0; });
+                if (error) break;
+                result = std::move(results[i]);
+                next_consume = i + 1;
+            }
+            changed.notify_all();
+            consume(std::move(result));
+        }
+    } catch (...) {
+        fail();
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+// Result of a sampling-based estimate of a search. Each '_error' field is the half-width of the 95%
+// confidence interval of the estimate next to it.
+struct CliqueCountEstimate {
+    // Estimated number of search tree nodes.
+    double tree_nodes = 0;
+    double tree_nodes_error = 0;
+    // Estimated number of maximal cliques.
+    double cliques = 0;
+    double cliques_error = 0;
+    // Estimated running time of the full search, in seconds.
+    double seconds = 0;
+    double seconds_error = 0;
+    // Number of root-to-leaf paths sampled.
+    int samples = 0;
+};
+
+// Receives each reported clique. The set is only valid during the call.
+using CliqueCallback = std::function<void(const std::set<int>&)>;
+
+// The cliques of one subproblem of an ordered parallel search, buffered until they are passed on.
+// Each one is charged to the budget, if any, while it is held: flush() releases it once the callback
+// has taken it, and whatever is left when the segment is destroyed, e.g. because the callback threw,
+// is released then. A moved-from segment is empty and keeps its budget.
+class CliqueSegment {
+public:
+    explicit CliqueSegment(MemoryBudget* memory = nullptr) : memory(memory) {}
+
+    ~CliqueSegment() {
+        clear();
+    }
+
+    CliqueSegment(CliqueSegment&& other) noexcept
+        : memory(other.memory), cliques(std::move(other.cliques)), next(other.next) {
+        other.cliques.clear();
+        other.next = 0;
+    }
+
+    CliqueSegment& operator=(CliqueSegment&& other) noexcept {
+        if (this != &other) {
+            clear();
+            memory = other.memory;
+            cliques = std::move(other.cliques);
+            next = other.next;
+            other.cliques.clear();
+            other.next = 0;
+        }
+        return *this;
+    }
+
+    CliqueSegment(const CliqueSegment&) = delete;
+    CliqueSegment& operator=(const CliqueSegment&) = delete;
+
+    // Appends a copy of the clique, or drops it if charging it exceeds the budget.
+    void add(const std::set<int>& clique) {
+        if (!memory || memory->charge(set_memory_bytes(clique))) {
+            cliques.push_back(clique);
+        } else {
+            memory->release(set_memory_bytes(clique));
+        }
+    }
+
+    // Passes the cliques to on_clique in order, freeing and releasing each one as soon as it returns.
+    void flush(const CliqueCallback& on_clique) {
+        for (; next < cliques.size(); ++next) {
+            on_clique(cliques[next]);
+            release(cliques[next]);
+        }
+        clear();
+    }
+
+    // Drops the cliques not passed on yet.
+    void clear() {
+        for (; next < cliques.size(); ++next) {
+            release(cliques[next]);
+        }
+        cliques.clear();
+        next = 0;
+    }
+
+    size_t size() const {
+        return cliques.size() - next;
+    }
+
+private:
+    void release(std::set<int>& clique) {
+        if (memory) {
+            memory->release(set_memory_bytes(clique));
+        }
+        clique.clear();
+    }
+
+    MemoryBudget* memory;
+    std::vector<std::set<int>> cliques;
+    // The first clique not passed on or released yet.
+    size_t next = 0;
+};
+
+// Read-only view of the graph handed to pivot policies.
+struct PivotView {
+    const std::vector<std::vector<bool>>& adj_matrix;
+    // Global degree of every vertex.
+    const std::vector<int>& degrees;
+};
+
+// Pivot selection policies. Each one is a plain class whose select() returns the pivot u chosen from
+// P and X, so the search only branches on P \ N(u); returning -1 means "no pivot" and branches on all
+// of P. They are template arguments of the search and are inlined, with no virtual dispatch.
+
+// Tomita et al.: the vertex of P and X with the most neighbors in P, which minimizes the branching.
+struct TomitaPivot {
+    int select(const PivotView& g, const std::set<int>& P, const std::set<int>& X) {
+        int best = -1, best_count = -1;
+        auto consider = [&](int u) {
+            int count = 0;
+            for (int v : P) {
+                count += g.adj_matrix[u][v];
+            }
+            if (count > best_count) {
+                best = u;
+                best_count = count;
+            }
+        };
+        for (int u : P) consider(u);
+        for (int u : X) consider(u);
+        return best;
+    }
+};
+
+// The first (lowest id) vertex of P.
+struct FirstVertexPivot {
+    int select(const PivotView&, const std::set<int>& P, const std::set<int>&) {
+        return *P.begin();
+    }
+};
+
+// The vertex of P with the highest global degree.
+struct MaxDegreePivot {
+    int select(const PivotView& g, const std::set<int>& P, const std::set<int>&) {
+        int u = *P.begin();
+        for (int v : P) {
+            if (g.degrees[v] > g.degrees[u])
+              u = v;
+        }
+        return u;
+    }
+};
+
+// A uniformly random vertex of P.
+struct RandomPivot {
+    std::mt19937 rng;
+
+    explicit RandomPivot(unsigned seed = 1) : rng(seed) {}
+
+    int select(const PivotView&, const std::set<int>& P, const std::set<int>&) {
+        auto it = P.begin();
+        std::advance(it, std::uniform_int_distribution<size_t>(0, P.size() - 1)(rng));
+        return *it;
+    }
+};
+
+// Sampling-based pivot in the spirit of Naude's refined selection: scores only a few random
+// vertices of P and X by |P & N(u)| instead of all of them, and stops early on a vertex that
+// leaves at most one branch.
+struct NaudePivot {
+    std::mt19937 rng;
+    int samples;
+
+    explicit NaudePivot(int samples = 8, unsigned seed = 1) : rng(seed), samples(samples) {}
+
+    int select(const PivotView& g, const std::set<int>& P, const std::set<int>& X) {
+        std::vector<int> pool(P.begin(), P.end());
+        pool.insert(pool.end(), X.begin(), X.end());
+        int best = *P.begin(), best_count = -1;
+        int draws = std::min(samples, static_cast<int>(pool.size()));
+        for (int i = 0; i < draws; ++i) {
+            // Partial Fisher-Yates shuffle, so no vertex is scored twice.
+            std::swap(pool[i], pool[std::uniform_int_distribution<size_t>(i, pool.size() - 1)(rng)]);
+            int u = pool[i], count = 0;
+            for (int v : P) {
+                count += g.adj_matrix[u][v];
+            }
+            if (count > best_count) {
+                best = u;
+                best_count = count;
+            }
+            if (best_count + 1 >= static_cast<int>(P.size())) {
+                break;
+            }
+        }
+        return best;
+    }
+};
+
+// No pivoting: branches on every vertex of P, the plain Bron-Kerbosch baseline.
+struct NoPivot {
+    int select(const PivotView&, const std::set<int>&, const std::set<int>&) {
+        return -1;
+    }
+};
+
+class Graph {
+public:
+    int num_vertices;
+    std::vector<std::vector<bool>> adj_matrix;
+    // The same adjacency packed into 64-bit words, for bitset-parallel operations.
+    std::vector<std::vector<uint64_t>> adj_bits;
+
+    /**
+     * @brief Constructor for the Graph class.
+     * @param n The number of vertices in the graph.
+     */
+    Graph(int n) : num_vertices(n), adj_matrix(n, std::vector<bool>(n, false)),
+                   adj_bits(n, std::vector<uint64_t>((n + 63) / 64, 0)), degrees(n, 0) {}
+
+    /**
+     * @brief Adds an undirected edge between vertices u and v.
+     * @param u The first vertex.
+     * @param v The second vertex.
+     */
+    void add_edge(int u, int v) {
+        if (u >= 0 && u < num_vertices && v >= 0 && v < num_vertices) {
+            if (!adj_matrix[u][v]) {
+                degrees[u]++;
+                if (u != v) degrees[v]++;
+            }
+            adj_matrix[u][v] = true;
+            adj_matrix[v][u] = true;
+            adj_bits[u][v / 64] |= uint64_t(1) << (v % 64);
+            adj_bits[v][u / 64] |= uint64_t(1) << (u % 64);
+        }
+    }
+
+    /**
+     * @brief Removes the undirected edge between vertices u and v, if present.
+     * @param u The first vertex.
+     * @param v The second vertex.
+     */
+    void remove_edge(int u, int v) {
+        if (u >= 0 && u < num_vertices && v >= 0 && v < num_vertices) {
+            if (adj_matrix[u][v]) {
+                degrees[u]--;
+                if (u != v) degrees[v]--;
+            }
+            adj_matrix[u][v] = false;
+            adj_matrix[v][u] = false;
+            adj_bits[u][v / 64] &= ~(uint64_t(1) << (v % 64));
+            adj_bits[v][u / 64] &= ~(uint64_t(1) << (u % 64));
+        }
+    }
+    
+    /**
+     * @brief Finds all maximal cliques in the graph using the Bron-Kerbosch algorithm.
+     * @brief A clique is a subset of vertices in a graph where every two distinct vertices are connected by an edge.
+     *        In other words, a clique is a complete subgraph of the original graph.
+     *        A maximal clique is a clique that cannot be extended by including one more adjacent vertex, meaning
+     *        it is not a subset of a larger clique.
+     * @return A vector of sets, where each set represents a maximal clique.
+     * @note Time Complexity: The worst-case time complexity of the Bron-Kerbosch algorithm
+     *       is O(3^(n/3)), where n is the number of vertices.
+     * @note Space Complexity: The space complexity is O(n + m), where n is the number of vertices, and m is the number of edges.
+     */
+    std::vector<std::set<int>> find_max_cliques() {
+        // 'cliques' stores all maximal cliques found.
+        // 'R' is the current clique being built.
+        // 'P' is the set of candidate vertices that could be added to the clique.
+        // 'X' is the set of vertices that have already been processed and cannot be added to the clique.
+        std::vector<std::set<int>> cliques;
+        std::set<int> R, P, X;
+        for (int i = 0; i < num_vertices; ++i) {
+            P.insert(i);
+        }
+        if (num_vertices > 0) {
+            CliqueSearchStats stats;
+            MemoryBudget budget;
+            CliqueSearchOptions options;
+            options.memory = &budget;
+            run_search(R, P, X, collect_into(cliques, &budget), options, stats, MaxDegreePivot());
+        }
+        return cliques;
+    }
+
+    /**
+     * @brief Finds the maximal cliques whose size lies in [min_size, max_size].
+     * @brief Cliques larger than max_size are truncated: the search stops descending once R has
+     *        max_size vertices and reports R as a size-max_size clique, so every maximal clique larger
+     *        than max_size is represented by at least one of its size-max_size subsets.
+     * @param min_size The minimum clique size to report.
+     * @param max_size The size at which cliques are truncated.
+     * @return A vector of sets, where each set represents a reported clique.
+     * @note Vertices whose core number is below min_size - 1 cannot be part of a clique with min_size
+     *       vertices and are dropped before the search, and any branch with |R| + |P| < min_size is pruned.
+     */
+    std::vector<std::set<int>> find_max_cliques(int min_size, int max_size) {
+        CliqueSearchOptions options;
+        options.min_size = min_size;
+        options.max_size = max_size;
+        return find_max_cliques(options);
+    }
+
+    /**
+     * @brief Finds all maximal cliques subject to the given search options.
+     * @param options The size bounds, coloring bound depth and vertex ordering of the search.
+     * @return A vector of sets, where each set represents a reported clique.
+     */
+    std::vector<std::set<int>> find_max_cliques(const CliqueSearchOptions& options) {
+        CliqueSearchStats stats;
+        return find_max_cliques(options, stats);
+    }
+
+    /**
+     * @brief Finds all maximal cliques subject to the given search options and records search counters.
+     * @param options The size bounds, coloring bound depth and vertex ordering of the search.
+     * @param stats Receives the instrumentation counters of the search.
+     * @return A vector of sets, where each set represents a reported clique.
+     */
+    std::vector<std::set<int>> find_max_cliques(const CliqueSearchOptions& options, CliqueSearchStats& stats) {
+        return find_max_cliques_with_pivot<MaxDegreePivot>(options, stats);
+    }
+
+    /**
+     * @brief Finds all maximal cliques using the given pivot selection policy.
+     * @param options The size bounds, coloring bound depth and vertex ordering of the search.
+     * @param stats Receives the instrumentation counters of the search.
+     * @param pivot The pivot policy, e.g. TomitaPivot or NoPivot. It is copied into the search,
+     *              so seeded policies give reproducible results.
+     * @return A vector of sets, where each set represents a reported clique. If options.memory was
+     *         exceeded, the cliques found before the search stopped.
+     * @note The reported cliques do not depend on the policy, only the shape of the search tree does.
+     * @note The collected cliques count towards the memory budget while the search runs and are
+     *       released from it when they are returned.
+     */
+    template <typename PivotPolicy>
+    std::vector<std::set<int>> find_max_cliques_with_pivot(const CliqueSearchOptions& options, CliqueSearchStats& stats,
+                                                 PivotPolicy pivot = PivotPolicy()) {
+        std::vector<std::set<int>> cliques;
+        MemoryBudget local_budget;
+        CliqueSearchOptions tracked = options;
+        if (!tracked.memory) tracked.memory = &local_budget;
+        for_each_max_clique(collect_into(cliques, tracked.memory), tracked, stats, pivot);
+        if (options.memory) {
+            for (const auto& clique : cliques) {
+                options.memory->release(set_memory_bytes(clique));
+            }
+        }
+        return cliques;
+    }
+
+    /**
+     * @brief Streams the maximal cliques to a callback instead of collecting them.
+     * @param on_clique Called once per reported clique, in search order.
+     * @param options The size bounds, coloring bound depth and vertex ordering of the search.
+     * @param stats Receives the instrumentation counters of the search.
+     * @param pivot The pivot policy of the search.
+     * @note Memory use stays bounded by the search itself, whatever the number of cliques.
+     */
+    template <typename PivotPolicy = MaxDegreePivot>
+    void for_each_max_clique(const CliqueCallback& on_clique, const CliqueSearchOptions& options,
+                             CliqueSearchStats& stats, PivotPolicy pivot = PivotPolicy()) {
+        stats = CliqueSearchStats();
+        if (num_vertices == 0 || options.max_size < 1 || options.min_size > options.max_size) {
+            return;
+        }
+        std::set<int> R, P = initial_candidates(options), X;
+        run_search(R, P, X, on_clique, options, stats, pivot);
+    }
+
+    /**
+     * @brief Streams the maximal cliques to a callback using several threads.
+     * @brief The branches of the root of the search tree are independent subproblems once the root has
+     *        been expanded, so they are handed out to the worker threads one at a time.
+     * @brief With options.deterministic, every task collects its cliques into its own segment, and the
+     *        segments are passed on in task order through a reorder buffer (run_in_order) while the
+     *        workers go on with later tasks. The tasks are the same for any number of threads and
+     *        every task is searched with a fresh copy of the pivot policy, so the output is too.
+     * @param on_clique Called once per reported clique. Calls are serialized by an internal lock, but
+     *                  come from the worker threads and in no particular order; with
+     *                  options.deterministic they come from the calling thread, in task order.
+     *                  If it throws, no more tasks are started and the exception is rethrown on the
+     *                  calling thread once the workers have stopped.
+     * @param num_threads The number of worker threads; 1 or less runs the serial search, or with
+     *                    options.deterministic solves the tasks on the calling thread.
+     * @param options The size bounds, coloring bound depth, vertex ordering and output order of the search.
+     * @param stats Receives the instrumentation counters, summed over the workers.
+     * @param pivot The pivot policy; every worker gets its own copy.
+     */
+    template <typename PivotPolicy = MaxDegreePivot>
+    void for_each_max_clique_parallel(const CliqueCallback& on_clique, int num_threads,
+                                      const CliqueSearchOptions& options, CliqueSearchStats& stats,
+                                      PivotPolicy pivot = PivotPolicy()) {
+        if (num_threads <= 1 && !options.deterministic) {
+            for_each_max_clique(on_clique, options, stats, pivot);
+            return;
+        }
+        num_threads = std::max(1, num_threads);
+        stats = CliqueSearchStats();
+        if (num_vertices == 0 || options.max_size < 1 || options.min_size > options.max_size) {
+            return;
+        }
+        MemoryBudget local_budget;
+        MemoryBudget* memory = options.memory ? options.memory : &local_budget;
+        std::set<int> P = initial_candidates(options), X;
+        std::vector<RootTask> tasks;
+        SearchTables tables = make_search_tables(options);
+        if (options.progress) {
+            options.progress->reset();
+        }
+        stats.nodes = 1;
+        if (static_cast<int>(P.size()) < options.min_size) {
+            stats.pruned = 1;
+        } else {
+            tasks = expand_root(P, X, tables, options, pivot);
+        }
+        size_t task_bytes = 0;
+        for (const RootTask& task : tasks) {
+            task_bytes += set_memory_bytes(task.R) + set_memory_bytes(task.P) + set_memory_bytes(task.X);
+        }
+        ScopedMemoryCharge task_charge(memory, task_bytes);
+        if (options.progress) {
+            options.progress->nodes.fetch_add(1, std::memory_order_relaxed);
+            if (!tasks.empty()) {
+                options.progress->begin(std::vector<double>(tasks.size(), 1.0));
+            }
+        }
+
+        std::vector<CliqueSearchStats> worker_stats(num_threads);
+        WorkerOptions worker_options(options, num_threads);
+        if (options.deterministic) {
+            // Every task's segment holds the charges of its cliques until they are passed on, or until it
+            // is dropped when the search stops early.
+            auto solve = [&](size_t i, int id) {
+                CliqueSegment segment(memory);
+                if (!task_charge.ok() || memory->exceeded()) {
+                    return segment;
+                }
+                // A fresh copy per task, so randomized policies do not depend on the scheduling.
+                PivotPolicy task_pivot = pivot;
+                CliqueCallback collect = [&segment](const std::set<int>& clique) { segment.add(clique); };
+                SearchContext ctx{worker_options[id], collect, worker_stats[id], tables, SIZE_MAX, nullptr, memory};
+                bron_kerbosch(tasks[i].R, tasks[i].P, tasks[i].X, ctx, task_pivot, nullptr);
+                if (options.progress) {
+                    options.progress->top_level_done.fetch_add(1, std::memory_order_relaxed);
+                }
+                return segment;
+            };
+            auto output = [&](CliqueSegment segment) { segment.flush(on_clique); };
+            run_in_order(tasks.size(), num_threads, 4 * static_cast<size_t>(num_threads), solve, output);
+        } else {
+            std::mutex output_mutex;
+            std::atomic<size_t> next_task{0};
+            // The first exception of any worker, e.g. from on_clique; the others then stop taking tasks.
+            std::exception_ptr error;
+            std::atomic<bool> failed{false};
+            auto worker = [&](int id) {
+                PivotPolicy local_pivot = pivot;
+                // Cliques are handed to the callback in batches to keep the lock out of the hot path.
+                std::vector<std::set<int>> batch;
+                auto flush = [&] {
+                    std::lock_guard<std::mutex> lock(output_mutex);
+                    for (const auto& clique : batch) {
+                        on_clique(clique);
+                    }
+                    batch.clear();
+                };
+                CliqueCallback buffer = [&](const std::set<int>& clique) {
+                    batch.push_back(clique);
+                    if (batch.size() >= 256) flush();
+                };
+                SearchContext ctx{worker_options[id], buffer, worker_stats[id], tables, SIZE_MAX, nullptr, memory};
+                try {
+                    for (size_t i; task_charge.ok() && !memory->exceeded() && !failed &&
+                                   (i = next_task.fetch_add(1)) < tasks.size();) {
+                        RootTask& task = tasks[i];
+                        bron_kerbosch(task.R, task.P, task.X, ctx, local_pivot, nullptr);
+                        flush();
+                        if (options.progress) {
+                            options.progress->top_level_done.fetch_add(1, std::memory_order_relaxed);
+                        }
+                    }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(output_mutex);
+                    if (!error) error = std::current_exception();
+                    failed = true;
+                }
+            };
+            std::vector<std::thread> threads;
+            for (int id = 0; id < num_threads; ++id) {
+                threads.emplace_back(worker, id);
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        for (const auto& ws : worker_stats) {
+            stats.nodes += ws.nodes;
+            stats.cliques += ws.cliques;
+            stats.pruned += ws.pruned;
+            stats.max_depth = std::max(stats.max_depth, ws.max_depth);
+        }
+        record_memory_stats(*memory, stats);
+        if (options.progress) {
+            options.progress->finish();
+        }
+    }
+
+    /**
+     * @brief Finds the k largest maximal cliques.
+     * @brief Once k cliques have been found, the size of the smallest of them raises the search's
+     *        lower bound, so the size and coloring bounds prune ever more of the remaining search.
+     * @param k The number of cliques to return.
+     * @param options The search options; min_size acts as an initial lower bound.
+     * @param stats Receives the instrumentation counters of the search.
+     * @param pivot The pivot policy of the search.
+     * @return Up to k maximal cliques, largest first; cliques of equal size are in lexicographic order.
+     *         Among several cliques tied for the last place, the first ones found are kept.
+     */
+    template <typename PivotPolicy = MaxDegreePivot>
+    std::vector<std::set<int>> find_top_k_cliques(int k, const CliqueSearchOptions& options, CliqueSearchStats& stats,
+                                                  PivotPolicy pivot = PivotPolicy()) {
+        stats = CliqueSearchStats();
+        if (k <= 0 || num_vertices == 0 || options.max_size < 1 || options.min_size > options.max_size) {
+            return {};
+        }
+        std::set<int> R, P = initial_candidates(options), X;
+        return top_k_search(k, R, P, X, options, stats, pivot);
+    }
+
+    /**
+     * @brief Streams the maximal cliques that contain vertex v.
+     * @brief The search starts from R = {v} and P = N(v), so it only explores the neighborhood of v.
+     *        Degrees are kept by the graph and the min_size filter and core ordering use the cores
+     *        of N(v) alone, so beyond one O(n) key table for the degree and core orderings, its cost
+     *        does not grow with the rest of the graph.
+     * @param v The vertex the cliques must contain. Out-of-range vertices have no cliques.
+     * @param on_clique Called once per reported clique, in search order.
+     * @param options The size bounds, coloring bound depth and vertex ordering of the search.
+     * @param stats Receives the instrumentation counters of the search.
+     * @param pivot The pivot policy of the search.
+     */
+    template <typename PivotPolicy = MaxDegreePivot>
+    void for_each_max_clique_containing(int v, const CliqueCallback& on_clique, const CliqueSearchOptions& options,
+                                        CliqueSearchStats& stats, PivotPolicy pivot = PivotPolicy()) {
+        stats = CliqueSearchStats();
+        if (v < 0 || v >= num_vertices || options.max_size < 1 || options.min_size > options.max_size) {
+            return;
+        }
+        std::set<int> R = {v}, P = neighborhood_candidates(v, options), X;
+        run_search(R, P, X, on_clique, options, stats, pivot);
+    }
+
+    /**
+     * @brief Finds all maximal cliques that contain vertex v.
+     * @param v The vertex the cliques must contain.
+     * @return A vector of sets, where each set is a maximal clique of the whole graph containing v.
+     */
+    std::vector<std::set<int>> find_max_cliques_containing(int v) {
+        std::vector<std::set<int>> cliques;
+        CliqueSearchStats stats;
+        for_each_max_clique_containing(v, collect_into(cliques), CliqueSearchOptions(), stats);
+        return cliques;
+    }
+
+    /**
+     * @brief Finds the k largest maximal cliques that contain vertex v.
+     * @param v The vertex the cliques must contain.
+     * @param k The number of cliques to return; k = 1 gives a maximum clique containing v.
+     * @param options The search options; min_size acts as an initial lower bound.
+     * @param stats Receives the instrumentation counters of the search.
+     * @param pivot The pivot policy of the search.
+     * @return Up to k maximal cliques containing v, ordered as by find_top_k_cliques.
+     */
+    template <typename PivotPolicy = MaxDegreePivot>
+    std::vector<std::set<int>> find_top_k_cliques_containing(int v, int k, const CliqueSearchOptions& options,
+                                                             CliqueSearchStats& stats, PivotPolicy pivot = PivotPolicy()) {
+        stats = CliqueSearchStats();
+        if (k <= 0 || v < 0 || v >= num_vertices || options.max_size < 1 || options.min_size > options.max_size) {
+            return {};
+        }
+        std::set<int> R = {v}, P = neighborhood_candidates(v, options), X;
+        return top_k_search(k, R, P, X, options, stats, pivot);
+    }
+
+    /**
+     * @brief Computes the core number of every vertex.
+     * @brief The core number of v is the largest k such that v belongs to a subgraph in which every
+     *        vertex has degree at least k. A vertex in a clique of size s has core number at least s - 1.
+     * @return A vector with the core number of each vertex.
+     * @note Time Complexity: O(n^2) with the adjacency matrix, using the bucket-based peeling of
+     *       Batagelj and Zaversnik.
+     */
+    std::vector<int> core_numbers() {
+        std::vector<int> deg(num_vertices);
+        int max_degree = 0;
+        for (int v = 0; v < num_vertices; ++v) {
+            deg[v] = degree(v);
+            max_degree = std::max(max_degree, deg[v]);
+        }
+        // Vertices sorted by degree, with 'bin[d]' the first position of degree d.
+        std::vector<int> bin(max_degree + 2, 0), order(num_vertices), pos(num_vertices);
+        for (int v = 0; v < num_vertices; ++v) bin[deg[v] + 1]++;
+        for (int d = 1; d <= max_degree + 1; ++d) bin[d] += bin[d - 1];
+        std::vector<int> next_slot(bin.begin(), bin.end() - 1);
+        for (int v = 0; v < num_vertices; ++v) {
+            pos[v] = next_slot[deg[v]]++;
+            order[pos[v]] = v;
+        }
+        for (int i = 0; i < num_vertices; ++i) {
+            int v = order[i];
+            for (int u : get_neighbors(v)) {
+                if (deg[u] > deg[v]) {
+                    // Move u to the front of its bucket, then shrink the bucket by one.
+                    int du = deg[u], pu = pos[u], pw = bin[du], w = order[pw];
+                    if (u != w) {
+                        std::swap(order[pu], order[pw]);
+                        pos[u] = pw;
+                        pos[w] = pu;
+                    }
+                    bin[du]++;
+                    deg[u]--;
+                }
+            }
+        }
+        return deg;
+    }
+
+    /**
+     * @brief Colors the given vertices greedily so that adjacent vertices get different colors.
+     * @brief The number of colors is an upper bound on the size of any clique among the vertices.
+     * @param vertices The vertices to color.
+     * @param color Output indexed by vertex; receives the color of every vertex in 'vertices'.
+     * @return The number of colors used.
+     * @note Each color class is built bitset-parallel: take the lowest uncolored candidate and clear
+     *       its whole neighborhood from the candidates with one AND-NOT per 64 vertices.
+     */
+    int greedy_coloring(const std::set<int>& vertices, std::vector<int>& color) {
+        size_t words = (num_vertices + 63) / 64;
+        std::vector<uint64_t> uncolored(words, 0), candidates(words);
+        for (int v : vertices) {
+            uncolored[v / 64] |= uint64_t(1) << (v % 64);
+        }
+        int num_colors = 0;
+        size_t remaining = vertices.size();
+        while (remaining > 0) {
+            candidates = uncolored;
+            for (size_t w = 0; w < words; ++w) {
+                while (candidates[w]) {
+                    int v = static_cast<int>(w * 64 + __builtin_ctzll(candidates[w]));
+                    color[v] = num_colors;
+                    uncolored[w] &= ~(uint64_t(1) << (v % 64));
+                    remaining--;
+                    const std::vector<uint64_t>& row = adj_bits[v];
+                    for (size_t k = w; k < words; ++k) {
+                        candidates[k] &= ~row[k];
+                    }
+                    candidates[w] &= ~(uint64_t(1) << (v % 64));
+                }
+            }
+            num_colors++;
+        }
+        return num_colors;
+    }
+
+    /**
+     * @brief Finds the maximal cliques that contain at least one of the given seed vertices.
+     * @param seeds The seed vertices. Out-of-range vertices are ignored.
+     * @return A vector of sets, where each set represents a maximal clique intersecting 'seeds'.
+     *         Every such clique is reported exactly once.
+     * @note Each clique is attributed to its first seed (in set order): the subproblem for seed 'a'
+     *       puts earlier seeds into X, so a clique containing several seeds is only reported once.
+     *       This is the building block for incremental updates, since the maximal cliques that
+     *       avoid every endpoint of a changed edge are unaffected by the change.
+     */
+    std::vector<std::set<int>> find_max_cliques_touching(const std::set<int>& seeds) {
+        std::vector<std::set<int>> cliques;
+        std::set<int> processed;
+        for (int a : seeds) {
+            if (a < 0 || a >= num_vertices) continue;
+            std::set<int> R = {a}, P, X;
+            for (int neighbor : get_neighbors(a)) {
+                if (processed.count(neighbor)) {
+                    X.insert(neighbor);
+                } else {
+                    P.insert(neighbor);
+                }
+            }
+            CliqueSearchStats stats;
+            run_search(R, P, X, collect_into(cliques), CliqueSearchOptions(), stats, MaxDegreePivot());
+            processed.insert(a);
+        }
+        return cliques;
+    }
+
+    /**
+     * @brief Estimates the size of the search find_max_cliques_with_pivot<PivotPolicy> would run, without running it.
+     * @brief Uses Knuth's estimator: each sample walks one random root-to-leaf path of the search tree,
+     *        choosing a branch uniformly at every node. A node reached through branching factors
+     *        d1, ..., dk stands for d1 * ... * dk nodes, so summing these products along the path gives an
+     *        unbiased estimate of the tree size, and the product at a maximal-clique leaf (0 otherwise) an
+     *        unbiased estimate of the clique count. The estimates are averaged over the samples.
+     * @param samples The number of paths to sample; the error shrinks as 1 / sqrt(samples).
+     * @param seed The seed of the branch choices.
+     * @param pivot The pivot policy of the search to estimate.
+     * @return The estimated tree size, clique count and running time with their confidence intervals.
+     * @note The running time is the estimated tree size times the average cost of a node measured while
+     *       sampling, so it is only indicative of the real search.
+     * @note Time Complexity: O(samples * depth * n^2) in the worst case, independent of the clique count.
+     */
+    template <typename PivotPolicy = MaxDegreePivot>
+    CliqueCountEstimate estimate_max_cliques(int samples, unsigned seed = 1, PivotPolicy pivot = PivotPolicy()) {
+        CliqueCountEstimate estimate;
+        if (num_vertices == 0 || samples <= 0) {
+            return estimate;
+        }
+        std::set<int> P;
+        for (int i = 0; i < num_vertices; ++i) {
+            P.insert(i);
+        }
+        std::mt19937 rng(seed);
+        double node_sum = 0, node_sq_sum = 0, clique_sum = 0, clique_sq_sum = 0;
+        long long visited = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < samples; ++i) {
+            std::pair<double, double> path = sample_path(P, std::set<int>(), degrees, pivot, rng, visited);
+            node_sum += path.first;
+            node_sq_sum += path.first * path.first;
+            clique_sum += path.second;
+            clique_sq_sum += path.second * path.second;
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Mean and 95% confidence half-width from the sample variance.
+        auto summarize = [samples](double sum, double sq_sum, double& mean, double& error) {
+            mean = sum / samples;
+            double variance = samples > 1 ? std::max(0.0, (sq_sum - sum * mean) / (samples - 1)) : 0.0;
+            error = 1.96 * std::sqrt(variance / samples);
+        };
+        summarize(node_sum, node_sq_sum, estimate.tree_nodes, estimate.tree_nodes_error);
+        summarize(clique_sum, clique_sq_sum, estimate.cliques, estimate.cliques_error);
+        double seconds_per_node = elapsed / static_cast<double>(visited);
+        estimate.seconds = estimate.tree_nodes * seconds_per_node;
+        estimate.seconds_error = estimate.tree_nodes_error * seconds_per_node;
+        estimate.samples = samples;
+        return estimate;
+    }
+
+private:
+    // Degree of every vertex, kept up to date by add_edge and remove_edge.
+    std::vector<int> degrees;
+
+    // Solves the subproblems of the canonical-order search in sorted_output.h.
+    friend class SortedCliqueOutput;
+
+    // Walks one uniformly random path of the search tree below the subproblem (P, X), mirroring the
+    // branches of bron_kerbosch. Returns the path's estimates of the subtree size and clique count.
+    template <typename PivotPolicy>
+    std::pair<double, double> sample_path(std::set<int> P, std::set<int> X, const std::vector<int>& degrees, PivotPolicy& pivot,
+                                     std::mt19937& rng, long long& visited) {
+        double weight = 1, nodes = 0;
+        while (true) {
+            nodes += weight;
+            visited++;
+            if (P.empty()) {
+                return {nodes, X.empty() ? weight : 0.0};
+            }
+            int u = pivot.select(PivotView{adj_matrix, degrees}, P, X);
+            std::vector<int> branches;
+            for (int v : P) {
+                if (u < 0 || !is_neighbor(v, u)) {
+                    branches.push_back(v);
+                }
+            }
+            if (branches.empty()) {
+                // A pivot from X dominating P: nothing below this node is maximal.
+                return {nodes, 0.0};
+            }
+            size_t choice = std::uniform_int_distribution<size_t>(0, branches.size() - 1)(rng);
+            // Earlier siblings have been moved from P to X by the time the chosen branch runs.
+            for (size_t i = 0; i < choice; ++i) {
+                P.erase(branches[i]);
+                X.insert(branches[i]);
+            }
+            int v = branches[choice];
+            std::set<int> new_P, new_X;
+            for (int neighbor : get_neighbors(v)) {
+                if (P.count(neighbor)) {
+                    new_P.insert(neighbor);
+                }
+                if (X.count(neighbor)) {
+                    new_X.insert(neighbor);
+                }
+            }
+            weight *= static_cast<double>(branches.size());
+            P = std::move(new_P);
+            X = std::move(new_X);
+        }
+    }
+
+    // Per-vertex tables computed once per search and shared by all its subproblems and threads.
+    struct SearchTables {
+        // Global degree of every vertex: the graph's own table.
+        const std::vector<int>& degrees;
+        // Per-vertex sort key for the branching order, if the ordering needs one.
+        std::vector<int> order_key;
+    };
+
+    // State shared by every subproblem of one search.
+    struct SearchContext {
+        const CliqueSearchOptions& options;
+        const CliqueCallback& emit;
+        CliqueSearchStats& stats;
+        const SearchTables& tables;
+        // |R| at the root of the search, to recognize top-level subproblems for progress reporting.
+        size_t root_size;
+        // Lower bound on the clique size raised during the search (top-k), or null.
+        const int* min_size_floor;
+        // Charged with the scratch of every subproblem; the search stops once it is exceeded.
+        MemoryBudget* memory;
+        // Greedy colors of P for branch_order, indexed by vertex and allocated on first use; every
+        // entry is -1 between calls.
+        std::vector<int> branch_colors = {};
+
+        int min_size() const {
+            return min_size_floor ? std::max(options.min_size, *min_size_floor) : options.min_size;
+        }
+    };
+
+    // A top-level subproblem of a parallel search.
+    struct RootTask {
+        std::set<int> R, P, X;
+    };
+
+    // Appends every clique to 'cliques'. With a budget, each one is charged to it first and dropped
+    // if the budget is exceeded.
+    static CliqueCallback collect_into(std::vector<std::set<int>>& cliques, MemoryBudget* memory = nullptr) {
+        return [&cliques, memory](const std::set<int>& clique) {
+            if (!memory || memory->charge(set_memory_bytes(clique))) {
+                cliques.push_back(clique);
+            } else {
+                memory->release(set_memory_bytes(clique));
+            }
+        };
+    }
+
+
+    // The root candidates: all vertices, minus those whose core number rules out min_size.
+    std::set<int> initial_candidates(const CliqueSearchOptions& options) {
+        std::set<int> P;
+        if (options.min_size > 2) {
+            std::vector<int> core = core_numbers();
+            for (int i = 0; i < num_vertices; ++i) {
+                if (core[i] >= options.min_size - 1) {
+                    P.insert(i);
+                }
+            }
+        } else {
+            for (int i = 0; i < num_vertices; ++i) {
+                P.insert(i);
+            }
+        }
+        return P;
+    }
+
+    // The neighbors of v that can still be in a clique of min_size vertices with v: the other
+    // vertices of such a clique have min_size - 2 neighbors each among the neighbors of v.
+    std::set<int> neighborhood_candidates(int v, const CliqueSearchOptions& options) {
+        std::set<int> P;
+        std::vector<int> neighbors = get_neighbors(v);
+        if (options.min_size > 2) {
+            if (static_cast<int>(neighbors.size()) < options.min_size - 1) {
+                return P;
+            }
+            std::vector<int> core = local_core_numbers(neighbors);
+            for (size_t i = 0; i < neighbors.size(); ++i) {
+                if (core[i] >= options.min_size - 2) {
+                    P.insert(neighbors[i]);
+                }
+            }
+        } else {
+            P.insert(neighbors.begin(), neighbors.end());
+        }
+        return P;
+    }
+
+    // The core numbers of the subgraph induced by 'vertices', in the order of the list, peeling a
+    // vertex of least remaining degree at a time. O(k^2) for k vertices, independent of the graph.
+    std::vector<int> local_core_numbers(const std::vector<int>& vertices) {
+        int k = static_cast<int>(vertices.size());
+        std::vector<int> deg(k, 0), core(k, 0);
+        std::vector<char> peeled(k, 0);
+        for (int i = 0; i < k; ++i) {
+            for (int j = i + 1; j < k; ++j) {
+                if (adj_matrix[vertices[i]][vertices[j]]) {
+                    deg[i]++;
+                    deg[j]++;
+                }
+            }
+        }
+        int level = 0;
+        for (int step = 0; step < k; ++step) {
+            int u = -1;
+            for (int i = 0; i < k; ++i) {
+                if (!peeled[i] && (u < 0 || deg[i] < deg[u])) u = i;
+            }
+            level = std::max(level, deg[u]);
+            core[u] = level;
+            peeled[u] = 1;
+            for (int i = 0; i < k; ++i) {
+                if (!peeled[i] && adj_matrix[vertices[u]][vertices[i]]) deg[i]--;
+            }
+        }
+        return core;
+    }
+
+    // The tables of a search. With a scope, only the order keys of its vertices are filled, and the
+    // core ordering uses the cores of the subgraph it induces, so a search confined to a
+    // neighborhood does not pay for the whole graph.
+    SearchTables make_search_tables(const CliqueSearchOptions& options, const std::set<int>* scope = nullptr) {
+        SearchTables tables{degrees, {}};
+        switch (options.ordering) {
+            case VertexOrdering::DegreeDescending:
+            case VertexOrdering::DegreeAscending:
+                tables.order_key.resize(num_vertices);
+                if (scope) {
+                    for (int v : *scope) {
+                        tables.order_key[v] = options.ordering == VertexOrdering::DegreeDescending ? -degrees[v] : degrees[v];
+                    }
+                } else {
+                    for (int v = 0; v < num_vertices; ++v) {
+                        tables.order_key[v] = options.ordering == VertexOrdering::DegreeDescending ? -degrees[v] : degrees[v];
+                    }
+                }
+                break;
+            case VertexOrdering::CoreAscending:
+                if (scope) {
+                    std::vector<int> vertices(scope->begin(), scope->end());
+                    std::vector<int> core = local_core_numbers(vertices);
+                    tables.order_key.resize(num_vertices);
+                    for (size_t i = 0; i < vertices.size(); ++i) {
+                        tables.order_key[vertices[i]] = core[i];
+                    }
+                } else {
+                    tables.order_key = core_numbers();
+                }
+                break;
+            default:
+                break;
+        }
+        return tables;
+    }
+
+    // Expands the root (R empty) exactly as bron_kerbosch would and returns its branches as tasks.
+    template <typename PivotPolicy>
+    std::vector<RootTask> expand_root(std::set<int>& P, std::set<int>& X, const SearchTables& tables,
+                                      const CliqueSearchOptions& options, PivotPolicy& pivot) {
+        std::vector<RootTask> tasks;
+        if (P.empty()) return tasks;
+        int u = pivot.select(PivotView{adj_matrix, tables.degrees}, P, X);
+        std::set<int> P_minus_N;
+        for (int v : P) {
+            if (u < 0 || !is_neighbor(v, u)) P_minus_N.insert(v);
+        }
+        CliqueSearchStats unused_stats;
+        CliqueCallback unused_emit;
+        SearchContext ctx{options, unused_emit, unused_stats, tables, 0, nullptr, nullptr};
+        for (int v : branch_order(P_minus_N, P, ctx)) {
+            if (static_cast<int>(P.size()) < options.min_size) {
+                break;
+            }
+            RootTask task;
+            task.R.insert(v);
+            for (int neighbor : get_neighbors(v)) {
+                if (P.count(neighbor)) {
+                    task.P.insert(neighbor);
+                }
+                if (X.count(neighbor)) {
+                    task.X.insert(neighbor);
+                }
+            }
+            tasks.push_back(std::move(task));
+            P.erase(v);
+            X.insert(v);
+        }
+        return tasks;
+    }
+
+    template <typename PivotPolicy>
+    void run_search(std::set<int>& R, std::set<int>& P, std::set<int>& X, const CliqueCallback& emit,
+                    const CliqueSearchOptions& options, CliqueSearchStats& stats, PivotPolicy pivot) {
+        // Below a nonempty R, the search only branches on vertices of P.
+        SearchTables tables = make_search_tables(options, R.empty() ? nullptr : &P);
+        MemoryBudget local_budget;
+        MemoryBudget* memory = options.memory ? options.memory : &local_budget;
+        SearchContext ctx{options, emit, stats, tables, R.size(), nullptr, memory};
+        if (options.progress) {
+            options.progress->reset();
+        }
+        {
+            ScopedMemoryCharge root_charge(memory, set_memory_bytes(R) + set_memory_bytes(P) + set_memory_bytes(X));
+            if (root_charge.ok()) {
+                bron_kerbosch(R, P, X, ctx, pivot, nullptr);
+            }
+        }
+        record_memory_stats(*memory, stats);
+        if (options.progress) {
+            options.progress->finish();
+        }
+    }
+
+    // Keeps the k largest cliques reported by the search from (R, P, X), raising the size floor as it goes.
+    template <typename PivotPolicy>
+    std::vector<std::set<int>> top_k_search(int k, std::set<int>& R, std::set<int>& P, std::set<int>& X,
+                                            const CliqueSearchOptions& options, CliqueSearchStats& stats,
+                                            PivotPolicy& pivot) {
+        auto larger = [](const std::set<int>& a, const std::set<int>& b) { return a.size() > b.size(); };
+        // Min-heap on size holding the best k cliques so far.
+        std::priority_queue<std::set<int>, std::vector<std::set<int>>, decltype(larger)> best(larger);
+        int floor = 0;
+        MemoryBudget local_budget;
+        MemoryBudget* memory = options.memory ? options.memory : &local_budget;
+        // The heap's cliques are charged while they are held.
+        CliqueCallback keep = [&](const std::set<int>& clique) {
+            if (static_cast<int>(best.size()) < k) {
+                if (!memory->charge(set_memory_bytes(clique))) {
+                    memory->release(set_memory_bytes(clique));
+                    return;
+                }
+                best.push(clique);
+            } else if (clique.size() > best.top().size()) {
+                memory->release(set_memory_bytes(best.top()));
+                best.pop();
+                memory->charge(set_memory_bytes(clique));
+                best.push(clique);
+            }
+            if (static_cast<int>(best.size()) == k) {
+                floor = static_cast<int>(best.top().size()) + 1;
+            }
+        };
+        SearchTables tables = make_search_tables(options, R.empty() ? nullptr : &P);
+        SearchContext ctx{options, keep, stats, tables, R.size(), &floor, memory};
+        if (options.progress) {
+            options.progress->reset();
+        }
+        {
+            ScopedMemoryCharge root_charge(memory, set_memory_bytes(R) + set_memory_bytes(P) + set_memory_bytes(X));
+            if (root_charge.ok()) {
+                bron_kerbosch(R, P, X, ctx, pivot, nullptr);
+            }
+        }
+        record_memory_stats(*memory, stats);
+        if (options.progress) {
+            options.progress->finish();
+        }
+        std::vector<std::set<int>> result;
+        while (!best.empty()) {
+            memory->release(set_memory_bytes(best.top()));
+            result.push_back(best.top());
+            best.pop();
+        }
+        std::sort(result.begin(), result.end(), [](const std::set<int>& a, const std::set<int>& b) {
+            return a.size() != b.size() ? a.size() > b.size() : a < b;
+        });
+        return result;
+    }
+
+    void report_clique(const std::set<int>& R, SearchContext& ctx) {
+        BK_PROFILE_SCOPE(ctx.options.profiler, SearchPhase::Output);
+        ctx.emit(R);
+        ctx.stats.cliques++;
+        if (ctx.options.progress) {
+            ctx.options.progress->cliques.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Estimates the subtree size of every top-level branch, for weighting the progress ETA.
+    template <typename PivotPolicy>
+    std::vector<double> top_level_weights(const std::vector<int>& branches, std::set<int> P, std::set<int> X, SearchContext& ctx,
+                                     const PivotPolicy& pivot) {
+        int samples = ctx.options.progress->estimate_samples;
+        std::vector<double> weights(branches.size(), 1.0);
+        if (samples <= 0) return weights;
+        PivotPolicy sampler = pivot;
+        std::mt19937 rng(1);
+        long long visited = 0;
+        for (size_t i = 0; i < branches.size(); ++i) {
+            int v = branches[i];
+            std::set<int> new_P, new_X;
+            for (int neighbor : get_neighbors(v)) {
+                if (P.count(neighbor)) {
+                    new_P.insert(neighbor);
+                }
+                if (X.count(neighbor)) {
+                    new_X.insert(neighbor);
+                }
+            }
+            double sum = 0;
+            for (int s = 0; s < samples; ++s) {
+                sum += sample_path(new_P, new_X, ctx.tables.degrees, sampler, rng, visited).first;
+            }
+            weights[i] = sum / samples;
+            P.erase(v);
+            X.insert(v);
+        }
+        return weights;
+    }
+
+    // Returns the vertices of 'P_minus_N' in the branching order of the search. 'coloring_of_P' is the
+    // greedy coloring of exactly this P if the caller computed one for the coloring bound; otherwise
+    // ColorDescending colors P into the context's scratch and resets P's entries afterwards.
+    std::vector<int> branch_order(const std::set<int>& P_minus_N, const std::set<int>& P, SearchContext& ctx,
+                                  const std::vector<int>* coloring_of_P = nullptr) {
+        std::vector<int> order(P_minus_N.begin(), P_minus_N.end());
+        if (ctx.options.ordering == VertexOrdering::ColorDescending) {
+            std::vector<int>& scratch = ctx.branch_colors;
+            if (!coloring_of_P) {
+                if (scratch.empty()) {
+                    scratch.assign(num_vertices, -1);
+                }
+                greedy_coloring(P, scratch);
+            }
+            const std::vector<int>& color = coloring_of_P ? *coloring_of_P : scratch;
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return color[a] > color[b]; });
+            if (!coloring_of_P) {
+                for (int v : P) {
+                    scratch[v] = -1;
+                }
+            }
+        } else if (!ctx.tables.order_key.empty()) {
+            const std::vector<int>& key = ctx.tables.order_key;
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return key[a] < key[b]; });
+        }
+        return order;
+    }
+
+    template <typename PivotPolicy>
+    void bron_kerbosch(std::set<int>& R, std::set<int>& P, std::set<int>& X, SearchContext& ctx, PivotPolicy& pivot,
+                       const std::vector<int>* inherited_coloring) {
+        const CliqueSearchOptions& options = ctx.options;
+        ctx.stats.nodes++;
+        if (ctx.options.progress) {
+            ctx.options.progress->nodes.fetch_add(1, std::memory_order_relaxed);
+        }
+        ctx.stats.max_depth = std::max(ctx.stats.max_depth, static_cast<int>(R.size()));
+        if (ctx.memory->exceeded()) {
+            return;
+        }
+        if (static_cast<int>(R.size() + P.size()) < ctx.min_size()) {
+            ctx.stats.pruned++;
+            return;
+        }
+        // A proper coloring of P bounds the clique size reachable from here. The parent's coloring
+        // restricted to this P is still proper, so deeper subproblems only count its distinct colors.
+        std::vector<int> coloring;
+        const std::vector<int>* current_coloring = inherited_coloring;
+        int colors_needed = ctx.min_size() - static_cast<int>(R.size());
+        if (options.coloring_depth >= 0 && colors_needed > 1) {
+            int num_colors;
+            if (static_cast<int>(R.size()) <= options.coloring_depth) {
+                coloring.assign(num_vertices, -1);
+                num_colors = greedy_coloring(P, coloring);
+                current_coloring = &coloring;
+            } else if (inherited_coloring) {
+                std::vector<bool> seen(P.size(), false);
+                num_colors = 0;
+                for (int v : P) {
+                    int c = (*inherited_coloring)[v];
+                    if (c >= static_cast<int>(seen.size())) {
+                        seen.resize(c + 1, false);
+                    }
+                    if (!seen[c]) {
+                        seen[c] = true;
+                        num_colors++;
+                    }
+                }
+            } else {
+                num_colors = static_cast<int>(P.size());
+            }
+            if (num_colors < colors_needed) {
+                ctx.stats.pruned++;
+                return;
+            }
+        }
+        if (P.empty() && X.empty()) {
+            report_clique(R, ctx);
+            return;
+        }
+        if (P.empty()) {
+             return;
+        }
+        if (static_cast<int>(R.size()) >= options.max_size) {
+            report_clique(R, ctx);
+            return;
+        }
+        std::vector<int> branches;
+        {
+            BK_PROFILE_SCOPE(options.profiler, SearchPhase::Pivot);
+            int u = pivot.select(PivotView{adj_matrix, ctx.tables.degrees}, P, X);
+            std::set<int> P_minus_N;
+            for (int v : P) {
+              if(u < 0 || !is_neighbor(v,u))
+                P_minus_N.insert(v);
+            }
+            // A coloring computed at this depth is the greedy coloring of this very P, so the branching
+            // order can reuse it; an inherited one belongs to an ancestor's P.
+            branches = branch_order(P_minus_N, P, ctx, coloring.empty() ? nullptr : &coloring);
+        }
+        ScopedMemoryCharge frame_charge(ctx.memory, (coloring.capacity() + branches.capacity()) * sizeof(int));
+        if (!frame_charge.ok()) {
+            return;
+        }
+        bool top_level = options.progress && R.size() == ctx.root_size;
+        if (top_level) {
+            options.progress->begin(top_level_weights(branches, P, X, ctx, pivot));
+        }
+        for (int v : branches) {
+            // P only shrinks from here on, so no later branch can reach min_size either.
+            if (static_cast<int>(R.size() + P.size()) < ctx.min_size()) {
+                break;
+            }
+            std::set<int> new_R;
+            {
+                BK_PROFILE_SCOPE(options.profiler, SearchPhase::Allocation);
+                new_R = R;
+                new_R.insert(v);
+            }
+            std::set<int> new_P, new_X;
+            {
+                BK_PROFILE_SCOPE(options.profiler, SearchPhase::Intersection);
+                for (int neighbor : get_neighbors(v)) {
+                    if (P.count(neighbor)) {
+                        new_P.insert(neighbor);
+                    }
+                    if (X.count(neighbor)) {
+                        new_X.insert(neighbor);
+                    }
+                }
+            }
+            ScopedMemoryCharge child_charge(ctx.memory,
+                                            set_memory_bytes(new_R) + set_memory_bytes(new_P) + set_memory_bytes(new_X));
+            if (!child_charge.ok()) {
+                break;
+            }
+            bron_kerbosch(new_R, new_P, new_X, ctx, pivot, current_coloring);
+            P.erase(v);
+            X.insert(v);
+            if (top_level) {
+                options.progress->top_level_done.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::vector<int> get_neighbors(int v) {
+        std::vector<int> neighbors;
+        for (int i = 0; i < num_vertices; ++i) {
+            if (adj_matrix[v][i]) {
+                neighbors.push_back(i);
+            }
+        }
+        return neighbors;
+    }
+
+     bool is_neighbor(int u, int v) {
+        return adj_matrix[u][v];
+    }
+
+    int degree(int u){
+        return degrees[u];
+    }
+};
+
+class ProbabilisticGraph {
+public:
+    int num_vertices;
+    // Edge existence, so adjacency tests stay a single bit lookup.
+    Graph graph;
+    // Per-vertex neighbor lists sorted by neighbor id, storing the edge probability as a float.
+    std::vector<std::vector<std::pair<int, float>>> edge_probs;
+
+    /**
+     * @brief Constructor for the ProbabilisticGraph class.
+     * @param n The number of vertices in the graph.
+     */
+    ProbabilisticGraph(int n) : num_vertices(n), graph(n), edge_probs(n) {}
+
+    /**
+     * @brief Adds an undirected edge between vertices u and v that exists with probability p.
+     * @param u The first vertex.
+     * @param v The second vertex.
+     * @param p The existence probability, in (0, 1]. Edges with p <= 0 are ignored; adding an
+     *          existing edge again overwrites its probability.
+     */
+    void add_edge(int u, int v, double p) {
+        if (u < 0 || u >= num_vertices || v < 0 || v >= num_vertices || u == v || p <= 0) {
+            return;
+        }
+        p = std::min(p, 1.0);
+        set_prob(u, v, static_cast<float>(p));
+        set_prob(v, u, static_cast<float>(p));
+        graph.add_edge(u, v);
+    }
+
+    /**
+     * @brief Returns the probability of the edge between u and v, or 0 if there is no edge.
+     */
+    double edge_probability(int u, int v) const {
+        if (!graph.adj_matrix[u][v]) return 0.0;
+        const auto& list = edge_probs[u];
+        auto it = std::lower_bound(list.begin(), list.end(), std::make_pair(v, 0.0f),
+                              [](const std::pair<int, float>& a, const std::pair<int, float>& b) { return a.first < b.first; });
+        return it->second;
+    }
+
+    /**
+     * @brief Returns the probability that the given vertex set is a clique, i.e. the product of
+     *        the probabilities of all its edges (0 if an edge is missing).
+     */
+    double clique_probability(const std::set<int>& clique) const {
+        double q = 1.0;
+        for (auto it = clique.begin(); it != clique.end(); ++it) {
+            for (auto jt = std::next(it); jt != clique.end(); ++jt) {
+                q *= edge_probability(*it, *jt);
+            }
+        }
+        return q;
+    }
+
+    /**
+     * @brief Finds all alpha-maximal cliques of the uncertain graph.
+     * @brief An alpha-clique is a vertex set whose clique probability (the product of its edge
+     *        probabilities) is at least alpha. It is alpha-maximal if no vertex can be added while
+     *        keeping the probability at least alpha.
+     * @param alpha The probability threshold, in (0, 1].
+     * @return A vector of sets, where each set represents an alpha-maximal clique.
+     * @note Every candidate carries the factor its addition would multiply into the probability of R.
+     *       A candidate is dropped as soon as q(R) times that factor falls below alpha, which is the
+     *       best probability any extension through it can reach, so hopeless branches are never entered.
+     * @note Time Complexity: O(n * 2^n) in the worst case, as for exact alpha-maximal clique enumeration.
+     */
+    std::vector<std::set<int>> find_alpha_max_cliques(double alpha) const {
+        std::vector<std::set<int>> cliques;
+        if (num_vertices == 0 || alpha > 1.0) return cliques;
+        std::vector<int> R;
+        std::vector<std::pair<int, double>> I, X;
+        for (int i = 0; i < num_vertices; ++i) {
+            I.push_back({i, 1.0});
+        }
+        enumerate_alpha(R, 1.0, I, X, alpha, cliques);
+        return cliques;
+    }
+
+private:
+    void set_prob(int u, int v, float p) {
+        auto& list = edge_probs[u];
+        auto it = std::lower_bound(list.begin(), list.end(), std::make_pair(v, 0.0f),
+                              [](const std::pair<int, float>& a, const std::pair<int, float>& b) { return a.first < b.first; });
+        if (it != list.end() && it->first == v) {
+            it->second = p;
+        } else {
+            list.insert(it, {v, p});
+        }
+    }
+
+    // Extends the candidate factors by vertex u: keeps the neighbors of u whose extended factor still
+    // reaches alpha together with the probability q of R + {u}.
+    void extend_candidates(int u, double q, const std::pair<int, double>* first, const std::pair<int, double>* last,
+                           double alpha, std::vector<std::pair<int, double>>& out) const {
+        for (const auto* it = first; it != last; ++it) {
+            if (!graph.adj_matrix[u][it->first]) continue;
+            double factor = it->second * edge_probability(u, it->first);
+            if (q * factor >= alpha) {
+                out.push_back({it->first, factor});
+            }
+        }
+    }
+
+    void enumerate_alpha(std::vector<int>& R, double q, const std::vector<std::pair<int, double>>& I,
+                         const std::vector<std::pair<int, double>>& X, double alpha, std::vector<std::set<int>>& cliques) const {
+        if (I.empty()) {
+            if (X.empty()) {
+                cliques.push_back(std::set<int>(R.begin(), R.end()));
+            }
+            return;
+        }
+        for (size_t i = 0; i < I.size(); ++i) {
+            int u = I[i].first;
+            double new_q = q * I[i].second;
+            std::vector<std::pair<int, double>> new_I, new_X;
+            extend_candidates(u, new_q, I.data() + i + 1, I.data() + I.size(), alpha, new_I);
+            // Candidates processed before u behave like X: their cliques were already reported.
+            extend_candidates(u, new_q, I.data(), I.data() + i, alpha, new_X);
+            extend_candidates(u, new_q, X.data(), X.data() + X.size(), alpha, new_X);
+            if (new_I.empty() && !new_X.empty()) continue;
+            R.push_back(u);
+            enumerate_alpha(R, new_q, new_I, new_X, alpha, cliques);
+            R.pop_back();
+        }
+    }
+};
+
+struct TemporalEdge {
+    int u;
+    int v;
+    long long time;
+};
+
+class TemporalGraph {
+public:
+    int num_vertices;
+    // Timestamped edge events, kept sorted by time. The same pair may appear several times.
+    std::vector<TemporalEdge> edges;
+
+    /**
+     * @brief Constructor for the TemporalGraph class.
+     * @param n The number of vertices in the graph.
+     */
+    TemporalGraph(int n) : num_vertices(n) {}
+
+    /**
+     * @brief Records an undirected edge between u and v observed at the given time.
+     * @param u The first vertex.
+     * @param v The second vertex.
+     * @param time The timestamp of the edge event.
+     * @note Events are inserted in time order: appending in non-decreasing time is amortized O(1),
+     *       an out-of-order event costs O(log m) to place plus the shift of the later events.
+     */
+    void add_edge(int u, int v, long long time) {
+        if (u >= 0 && u < num_vertices && v >= 0 && v < num_vertices && u != v) {
+            TemporalEdge edge{std::min(u, v), std::max(u, v), time};
+            if (edges.empty() || edges.back().time <= time) {
+                edges.push_back(edge);
+                return;
+            }
+            auto it = std::upper_bound(edges.begin(), edges.end(), time,
+                                  [](long long t, const TemporalEdge& e) { return t < e.time; });
+            edges.insert(it, edge);
+        }
+    }
+
+    /**
+     * @brief Returns the index range [first, last) of the edge events with begin <= time < end.
+     */
+    std::pair<size_t, size_t> window_range(long long begin, long long end) const {
+        auto by_time = [](const TemporalEdge& e, long long t) { return e.time < t; };
+        size_t first = std::lower_bound(edges.begin(), edges.end(), begin, by_time) - edges.begin();
+        size_t last = std::lower_bound(edges.begin(), edges.end(), end, by_time) - edges.begin();
+        return {first, std::max(first, last)};
+    }
+
+    /**
+     * @brief Builds the static snapshot of all edges observed in the window [begin, end).
+     */
+    Graph snapshot(long long begin, long long end) const {
+        Graph g(num_vertices);
+        auto range = window_range(begin, end);
+        for (size_t i = range.first; i < range.second; ++i) {
+            g.add_edge(edges[i].u, edges[i].v);
+        }
+        return g;
+    }
+
+    /**
+     * @brief Finds all maximal cliques of the snapshot over the time window [begin, end).
+     * @param begin The inclusive start of the window.
+     * @param end The exclusive end of the window.
+     * @return A vector of sets, where each set represents a maximal clique of the window.
+     */
+    std::vector<std::set<int>> find_max_cliques_in_window(long long begin, long long end) const {
+        return snapshot(begin, end).find_max_cliques();
+    }
+
+    /**
+     * @brief Finds the maximal Delta-cliques over the closed interval [begin, end].
+     * @brief A Delta-clique is a vertex set in which every pair of vertices interacts at least once in
+     *        every sub-interval of length 'delta' of [begin, end], i.e. the clique persists over the
+     *        whole interval. A pair is persistent if its first event is at most begin + delta, its last
+     *        event is at least end - delta, and no two consecutive events are more than 'delta' apart.
+     * @param begin The start of the interval.
+     * @param end The end of the interval.
+     * @param delta The maximum allowed gap between consecutive interactions of a pair.
+     * @return A vector of sets, where each set is a vertex-maximal Delta-clique over [begin, end].
+     * @note Time Complexity: O(m log m) to collect the persistent pairs plus one clique enumeration.
+     */
+    std::vector<std::set<int>> find_delta_cliques(long long begin, long long end, long long delta) const {
+        Graph g(num_vertices);
+        auto range = window_range(begin, end + 1);
+        std::vector<TemporalEdge> events(edges.begin() + range.first, edges.begin() + range.second);
+        std::stable_sort(events.begin(), events.end(), [](const TemporalEdge& a, const TemporalEdge& b) {
+            return a.u != b.u ? a.u < b.u : a.v < b.v;
+        });
+        for (size_t i = 0; i < events.size();) {
+            size_t j = i;
+            long long previous = begin;
+            bool persistent = true;
+            for (; j < events.size() && events[j].u == events[i].u && events[j].v == events[i].v; ++j) {
+                if (events[j].time - previous > delta) persistent = false;
+                previous = events[j].time;
+            }
+            if (persistent && end - previous <= delta) {
+                g.add_edge(events[i].u, events[i].v);
+            }
+            i = j;
+        }
+        return g.find_max_cliques();
+    }
+};
+
+class SlidingWindowCliques {
+public:
+    /**
+     * @brief Starts a sliding-window enumeration over the window [begin, end) of a temporal graph.
+     * @param graph The temporal graph. It must outlive this object and not change while in use.
+     * @param begin The inclusive start of the initial window.
+     * @param end The exclusive end of the initial window.
+     */
+    SlidingWindowCliques(const TemporalGraph& graph, long long begin, long long end)
+        : graph(graph), window(graph.num_vertices), window_begin(begin), window_end(end),
+          multiplicity(graph.num_vertices, std::vector<int>(graph.num_vertices, 0)) {
+        range = graph.window_range(begin, end);
+        for (size_t i = range.first; i < range.second; ++i) {
+            add_event(graph.edges[i], nullptr);
+        }
+        current = window.find_max_cliques();
+    }
+
+    /**
+     * @brief Moves the window by 'shift' time units in both ends.
+     */
+    void slide(long long shift) {
+        slide_to(window_begin + shift, window_end + shift);
+    }
+
+    /**
+     * @brief Moves the window to [begin, end) and updates the maximal cliques incrementally.
+     * @note Only edge events entering or leaving the window are applied. A maximal clique that
+     *       avoids every endpoint of an edge that appeared or disappeared is still maximal, so
+     *       it is kept; only the cliques touching those endpoints are re-enumerated.
+     * @note Time Complexity: O(changed events) for the update plus the enumeration of the
+     *       maximal cliques that touch the affected vertices.
+     */
+    void slide_to(long long begin, long long end) {
+        std::pair<size_t, size_t> next = graph.window_range(begin, end);
+        std::set<int> affected;
+        // Events in the old range but not in the new one leave the window, and vice versa.
+        for (size_t i = range.first; i < std::min(range.second, next.first); ++i) remove_event(graph.edges[i], &affected);
+        for (size_t i = std::max(range.first, next.second); i < range.second; ++i) remove_event(graph.edges[i], &affected);
+        for (size_t i = next.first; i < std::min(next.second, range.first); ++i) add_event(graph.edges[i], &affected);
+        for (size_t i = std::max(next.first, range.second); i < next.second; ++i) add_event(graph.edges[i], &affected);
+        range = next;
+        window_begin = begin;
+        window_end = end;
+        if (affected.empty()) return;
+
+        std::vector<std::set<int>> kept;
+        for (auto& clique : current) {
+            bool touches = false;
+            for (int v : clique) {
+                if (affected.count(v)) {
+                    touches = true;
+                    break;
+                }
+            }
+            if (!touches) kept.push_back(std::move(clique));
+        }
+        for (auto& clique : window.find_max_cliques_touching(affected)) {
+            kept.push_back(std::move(clique));
+        }
+        current = std::move(kept);
+    }
+
+    /**
+     * @brief Returns the maximal cliques of the current window.
+     */
+    const std::vector<std::set<int>>& cliques() const {
+        return current;
+    }
+
+    long long begin() const { return window_begin; }
+    long long end() const { return window_end; }
+
+private:
+    const TemporalGraph& graph;
+    Graph window;
+    long long window_begin, window_end;
+    std::pair<size_t, size_t> range;
+    // Number of events of each pair inside the window; the edge exists while it is positive.
+    std::vector<std::vector<int>> multiplicity;
+    std::vector<std::set<int>> current;
+
+    void add_event(const TemporalEdge& e, std::set<int>* affected) {
+        if (multiplicity[e.u][e.v]++ == 0) {
+            multiplicity[e.v][e.u] = multiplicity[e.u][e.v];
+            window.add_edge(e.u, e.v);
+            if (affected) {
+                affected->insert(e.u);
+                affected->insert(e.v);
+            }
+        } else {
+            multiplicity[e.v][e.u] = multiplicity[e.u][e.v];
+        }
+    }
+
+    void remove_event(const TemporalEdge& e, std::set<int>* affected) {
+        multiplicity[e.v][e.u] = --multiplicity[e.u][e.v];
+        if (multiplicity[e.u][e.v] == 0) {
+            window.remove_edge(e.u, e.v);
+            if (affected) {
+                affected->insert(e.u);
+                affected->insert(e.v);
+            }
+        }
+    }
+};
+
+#endif  // BRON_KERBOSCH_H
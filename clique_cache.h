@@ -0,0 +1,278 @@
+#ifndef CLIQUE_CACHE_H
+#define CLIQUE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bron_kerbosch.h"
+
+// Counters of a CliqueCache.
+struct CliqueCacheStats {
+    long long hits = 0;
+    long long misses = 0;
+    long long evictions = 0;
+    size_t entries = 0;
+    // Memory held by the cached subgraphs and results.
+    size_t bytes = 0;
+};
+
+// An induced subgraph relabeled to 0..m-1 in increasing order of the original vertex ids, in
+// CSR form. Two vertex sets whose induced subgraphs are identical after this relabeling (e.g.
+// a community and its clone) have the same SubgraphKey.
+struct SubgraphKey {
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> targets;
+    uint64_t hash = 0;
+
+    bool operator==(const SubgraphKey& other) const {
+        return hash == other.hash && offsets == other.offsets && targets == other.targets;
+    }
+};
+
+/**
+ * @brief Content-addressed cache of maximal clique results.
+ * @brief Results are stored per induced subgraph, keyed by its relabeled CSR, in local labels, so a
+ *        query is answered from memory whenever an identical subgraph was solved before, whichever
+ *        vertices it came from. Entries are evicted least recently used first once the memory
+ *        budget is exceeded. All methods are thread-safe; the searches run outside the lock.
+ */
+class CliqueCache {
+public:
+    /**
+     * @brief Constructor for the CliqueCache class.
+     * @param memory_budget The maximum number of bytes held by cached subgraphs and results.
+     */
+    explicit CliqueCache(size_t memory_budget) : memory_budget(memory_budget) {}
+
+    CliqueCache(const CliqueCache&) = delete;
+    CliqueCache& operator=(const CliqueCache&) = delete;
+
+    /**
+     * @brief Finds the maximal cliques of the subgraph of g induced by the given vertices.
+     * @param g The graph.
+     * @param vertices The vertices of the subgraph. Out-of-range vertices are ignored.
+     * @return The maximal cliques of the induced subgraph, in original vertex ids.
+     * @note Time Complexity: O(m^2 / 64) to build the key for m vertices, plus the search on a miss.
+     */
+    std::vector<std::set<int>> max_cliques_induced(Graph& g, const std::set<int>& vertices) {
+        std::vector<int> labels;
+        for (int v : vertices) {
+            if (v >= 0 && v < g.num_vertices) labels.push_back(v);
+        }
+        return expand(solve(g, labels), labels, -1);
+    }
+
+    /**
+     * @brief Finds all maximal cliques of g, as Graph::find_max_cliques does.
+     */
+    std::vector<std::set<int>> max_cliques(Graph& g) {
+        std::vector<int> labels(g.num_vertices);
+        for (int v = 0; v < g.num_vertices; ++v) labels[v] = v;
+        return expand(solve(g, labels), labels, -1);
+    }
+
+    /**
+     * @brief Finds the maximal cliques containing vertex v, as Graph::find_max_cliques_containing does.
+     * @brief These are v added to each maximal clique of the subgraph induced by N(v), so the cached
+     *        entry is that of the neighborhood and is shared by every vertex with an identical one.
+     */
+    std::vector<std::set<int>> max_cliques_containing(Graph& g, int v) {
+        if (v < 0 || v >= g.num_vertices) return {};
+        std::vector<int> labels = neighborhood(g, v);
+        return expand(solve(g, labels), labels, v);
+    }
+
+    /**
+     * @brief Returns the number of maximal cliques containing vertex v without expanding them.
+     */
+    size_t count_max_cliques_containing(Graph& g, int v) {
+        if (v < 0 || v >= g.num_vertices) return 0;
+        return solve(g, neighborhood(g, v))->num_cliques();
+    }
+
+    /**
+     * @brief Returns the counters of the cache.
+     */
+    CliqueCacheStats stats() {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        CliqueCacheStats result = counters;
+        result.entries = entries.size();
+        result.bytes = bytes_used;
+        return result;
+    }
+
+    /**
+     * @brief Removes every entry; the hit and miss counters are kept.
+     */
+    void clear() {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        entries.clear();
+        index.clear();
+        bytes_used = 0;
+    }
+
+private:
+    // The maximal cliques of one subgraph in local labels, flattened: clique i is
+    // members[offsets[i]] .. members[offsets[i + 1] - 1].
+    struct CompactCliques {
+        std::vector<uint32_t> offsets{0};
+        std::vector<uint32_t> members;
+
+        size_t num_cliques() const {
+            return offsets.size() - 1;
+        }
+    };
+
+    struct Entry {
+        SubgraphKey key;
+        std::shared_ptr<const CompactCliques> cliques;
+        size_t bytes;
+    };
+
+    size_t memory_budget;
+    std::mutex cache_mutex;
+    std::list<Entry> entries;
+    std::unordered_multimap<uint64_t, std::list<Entry>::iterator> index;
+    size_t bytes_used = 0;
+    CliqueCacheStats counters;
+
+    static std::vector<int> neighborhood(const Graph& g, int v) {
+        std::vector<int> labels;
+        const std::vector<uint64_t>& row = g.adj_bits[v];
+        for (size_t w = 0; w < row.size(); ++w) {
+            for (uint64_t word = row[w]; word; word &= word - 1) {
+                labels.push_back(static_cast<int>(w * 64 + __builtin_ctzll(word)));
+            }
+        }
+        return labels;
+    }
+
+    // Builds the relabeled CSR of the subgraph induced by 'labels' (sorted, distinct).
+    static SubgraphKey make_key(const Graph& g, const std::vector<int>& labels) {
+        SubgraphKey key;
+        key.offsets.reserve(labels.size() + 1);
+        key.offsets.push_back(0);
+        // FNV-1a over the CSR arrays.
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](uint32_t value) {
+            hash = (hash ^ value) * 1099511628211ull;
+        };
+        mix(static_cast<uint32_t>(labels.size()));
+        for (int u : labels) {
+            const std::vector<uint64_t>& row = g.adj_bits[u];
+            for (size_t j = 0; j < labels.size(); ++j) {
+                int w = labels[j];
+                if (row[w / 64] >> (w % 64) & 1) {
+                    key.targets.push_back(static_cast<uint32_t>(j));
+                    mix(static_cast<uint32_t>(j));
+                }
+            }
+            key.offsets.push_back(static_cast<uint32_t>(key.targets.size()));
+            mix(~static_cast<uint32_t>(key.targets.size()));
+        }
+        key.hash = hash;
+        return key;
+    }
+
+    static size_t entry_bytes(const SubgraphKey& key, const CompactCliques& cliques) {
+        return sizeof(Entry) + sizeof(CompactCliques) +
+               sizeof(uint32_t) * (key.offsets.size() + key.targets.size() + cliques.offsets.size() +
+                                   cliques.members.size());
+    }
+
+    std::shared_ptr<const CompactCliques> solve(const Graph& g, const std::vector<int>& labels) {
+        SubgraphKey key = make_key(g, labels);
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            auto range = index.equal_range(key.hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second->key == key) {
+                    entries.splice(entries.begin(), entries, it->second);
+                    counters.hits++;
+                    return it->second->cliques;
+                }
+            }
+            counters.misses++;
+        }
+
+        Graph local(static_cast<int>(labels.size()));
+        for (size_t u = 0; u < labels.size(); ++u) {
+            for (uint32_t i = key.offsets[u]; i < key.offsets[u + 1]; ++i) {
+                if (key.targets[i] > u) local.add_edge(static_cast<int>(u), static_cast<int>(key.targets[i]));
+            }
+        }
+        auto cliques = std::make_shared<CompactCliques>();
+        // The empty subgraph has one maximal clique, the empty set.
+        if (labels.empty()) cliques->offsets.push_back(0);
+        CliqueSearchStats search_stats;
+        local.for_each_max_clique(
+            [&](const std::set<int>& clique) {
+                cliques->members.insert(cliques->members.end(), clique.begin(), clique.end());
+                cliques->offsets.push_back(static_cast<uint32_t>(cliques->members.size()));
+            },
+            CliqueSearchOptions(), search_stats, TomitaPivot());
+
+        size_t bytes = entry_bytes(key, *cliques);
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        if (bytes > memory_budget) {
+            return cliques;
+        }
+        // Another thread may have solved the same subgraph meanwhile; keep a single entry.
+        auto range = index.equal_range(key.hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second->key == key) return it->second->cliques;
+        }
+        uint64_t hash = key.hash;
+        entries.push_front(Entry{std::move(key), cliques, bytes});
+        index.emplace(hash, entries.begin());
+        bytes_used += bytes;
+        while (bytes_used > memory_budget) {
+            evict_last();
+        }
+        return cliques;
+    }
+
+    void evict_last() {
+        auto last = std::prev(entries.end());
+        auto range = index.equal_range(last->key.hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == last) {
+                index.erase(it);
+                break;
+            }
+        }
+        bytes_used -= last->bytes;
+        entries.erase(last);
+        counters.evictions++;
+    }
+
+    // Maps local labels back to vertex ids, adding 'extra' to every clique if it is not -1.
+    static std::vector<std::set<int>> expand(const std::shared_ptr<const CompactCliques>& cliques,
+                                             const std::vector<int>& labels, int extra) {
+        std::vector<std::set<int>> result;
+        result.reserve(cliques->num_cliques());
+        for (size_t i = 0; i < cliques->num_cliques(); ++i) {
+            std::set<int> clique;
+            for (uint32_t j = cliques->offsets[i]; j < cliques->offsets[i + 1]; ++j) {
+                clique.insert(labels[cliques->members[j]]);
+            }
+            if (extra >= 0) {
+                clique.insert(extra);
+            } else if (clique.empty()) {
+                continue;
+            }
+            result.push_back(std::move(clique));
+        }
+        return result;
+    }
+};
+
+#endif  // CLIQUE_CACHE_H
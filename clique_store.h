@@ -0,0 +1,423 @@
+#ifndef CLIQUE_STORE_H
+#define CLIQUE_STORE_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+#include "bron_kerbosch.h"
+
+/**
+ * @brief Result store for enumerations whose output does not fit in memory.
+ * @brief Cliques are appended to an in-memory buffer. Once it holds more than its byte limit, it
+ *        is sorted canonically (the order of std::set<int>'s operator<, in which the tests compare
+ *        results) and written as one compressed run to an unlinked temporary file, which the
+ *        operating system reclaims when the store is destroyed or the process exits. Readers merge
+ *        the runs with the buffer, either in canonical order or, more cheaply, run by run.
+ *
+ *        A run front-codes its cliques: each one is written as the length of the prefix it shares
+ *        with the previous clique, the number of remaining vertices, and the gaps between those
+ *        vertices, all as LEB128 varints. Adding is thread-safe, so the store can collect the output
+ *        of a parallel search directly; reading while cliques are still being added is not.
+ *
+ *        Given the search's MemoryBudget, the store charges it with the bytes its buffer holds, and
+ *        releases them as runs are spilled and when it is destroyed.
+ */
+class CliqueStore {
+public:
+    /**
+     * @brief Constructor for the CliqueStore class.
+     * @param buffer_bytes The size of the in-memory buffer; a run is spilled whenever it is exceeded.
+     * @param temp_dir The directory for the spill file; by default $TMPDIR, or /tmp.
+     * @param memory The budget charged with the buffer, if set; it must outlive the store. A failed
+     *               charge keeps the clique: the search it belongs to stops once the budget is
+     *               exceeded.
+     */
+    explicit CliqueStore(size_t buffer_bytes = size_t(64) << 20, const std::string& temp_dir = "",
+                         MemoryBudget* memory = nullptr)
+        : buffer_limit(buffer_bytes), directory(temp_dir), memory(memory) {
+        if (directory.empty()) {
+            const char* env = std::getenv("TMPDIR");
+            directory = env && *env ? env : "/tmp";
+        }
+    }
+
+    ~CliqueStore() {
+        if (fd >= 0) close(fd);
+        if (memory) memory->release(charged);
+    }
+
+    CliqueStore(const CliqueStore&) = delete;
+    CliqueStore& operator=(const CliqueStore&) = delete;
+
+    /**
+     * @brief Appends a clique, spilling the buffer first if it is full.
+     * @throws std::runtime_error if the spill file cannot be created or written.
+     */
+    void add(const std::set<int>& clique) {
+        long long change;
+        {
+            std::lock_guard<std::mutex> lock(store_mutex);
+            buffer.members.insert(buffer.members.end(), clique.begin(), clique.end());
+            buffer.offsets.push_back(static_cast<uint32_t>(buffer.members.size()));
+            total++;
+            if (buffer.bytes() > buffer_limit) {
+                spill_locked();
+            }
+            change = recharge_locked();
+        }
+        apply_charge(change);
+    }
+
+    /**
+     * @brief Returns a callback that adds every clique it receives to the store.
+     */
+    CliqueCallback collector() {
+        return [this](const std::set<int>& clique) { add(clique); };
+    }
+
+    /**
+     * @brief Writes the buffered cliques out as a run, whatever their size; e.g. from a
+     *        MemoryBudget::on_exceeded handler.
+     * @return The number of bytes freed from the buffer.
+     */
+    size_t spill() {
+        size_t freed;
+        long long change;
+        {
+            std::lock_guard<std::mutex> lock(store_mutex);
+            freed = spill_locked();
+            change = recharge_locked();
+        }
+        apply_charge(change);
+        return freed;
+    }
+
+    /**
+     * @brief Returns the number of cliques added.
+     */
+    size_t size() const {
+        return total;
+    }
+
+    /**
+     * @brief Returns the number of runs spilled to disk.
+     */
+    size_t num_runs() const {
+        return runs.size();
+    }
+
+    /**
+     * @brief Returns the number of bytes of the spill file.
+     */
+    size_t spilled_bytes() const {
+        return file_size;
+    }
+
+    /**
+     * @brief Returns the number of bytes held by the in-memory buffer.
+     */
+    size_t buffered_bytes() const {
+        return buffer.bytes();
+    }
+
+    // Reads the cliques of a store, in canonical order or run by run.
+    class Reader {
+    public:
+        /**
+         * @brief Reads the next clique into 'clique', as increasing vertex ids.
+         * @return False once every clique has been read.
+         * @throws std::runtime_error if the spill file cannot be read.
+         */
+        bool next(std::vector<int>& clique) {
+            if (!sorted) {
+                while (current < cursors.size()) {
+                    if (cursors[current].advance()) {
+                        clique = cursors[current].clique;
+                        return true;
+                    }
+                    current++;
+                }
+                return false;
+            }
+            if (heap.empty()) return false;
+            std::pop_heap(heap.begin(), heap.end(), HeadGreater{this});
+            size_t i = heap.back();
+            clique = cursors[i].clique;
+            if (cursors[i].advance()) {
+                std::push_heap(heap.begin(), heap.end(), HeadGreater{this});
+            } else {
+                heap.pop_back();
+            }
+            return true;
+        }
+
+    private:
+        friend class CliqueStore;
+
+        // One sorted source: a spilled run, or the buffer in the order given by 'order'.
+        struct Cursor {
+            const CliqueStore* store = nullptr;
+            // Spilled run: the undecoded range of the file and a block read from it.
+            uint64_t offset = 0, end = 0;
+            std::vector<uint8_t> block;
+            size_t pos = 0;
+            size_t remaining = 0;
+            // Buffer: the indices of its cliques still to read.
+            std::vector<uint32_t> order;
+            size_t next_index = 0;
+            bool in_memory = false;
+            // The clique at the head of the cursor; a run's next clique is decoded against it.
+            std::vector<int> clique;
+
+            // Moves to the next clique; returns false at the end.
+            bool advance() {
+                if (in_memory) {
+                    if (next_index == order.size()) return false;
+                    const Buffer& buffer = store->buffer;
+                    uint32_t i = order[next_index++];
+                    clique.assign(buffer.members.begin() + buffer.offsets[i],
+                                  buffer.members.begin() + buffer.offsets[i + 1]);
+                    return true;
+                }
+                if (remaining == 0) return false;
+                remaining--;
+                size_t shared = read_varint();
+                size_t suffix = read_varint();
+                clique.resize(shared);
+                int previous = shared > 0 ? clique.back() : -1;
+                for (size_t k = 0; k < suffix; ++k) {
+                    previous += static_cast<int>(read_varint()) + 1;
+                    clique.push_back(previous);
+                }
+                return true;
+            }
+
+            uint64_t read_varint() {
+                uint64_t value = 0;
+                for (int shift = 0;; shift += 7) {
+                    if (pos == block.size()) refill();
+                    uint8_t byte = block[pos++];
+                    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                    if (!(byte & 0x80)) return value;
+                }
+            }
+
+            void refill() {
+                size_t length = static_cast<size_t>(std::min<uint64_t>(end - offset, 1 << 16));
+                if (length == 0) throw std::runtime_error("clique store: truncated run");
+                block.resize(length);
+                store->read_at(block.data(), length, offset);
+                offset += length;
+                pos = 0;
+            }
+        };
+
+        // Orders cursors by their head cliques, greatest first, for a min-heap.
+        struct HeadGreater {
+            const Reader* reader;
+            bool operator()(size_t a, size_t b) const {
+                return reader->cursors[b].clique < reader->cursors[a].clique;
+            }
+        };
+
+        bool sorted;
+        std::vector<Cursor> cursors;
+        size_t current = 0;
+        // Min-heap of the cursors that have a head clique, when merging.
+        std::vector<size_t> heap;
+
+        Reader(const CliqueStore& store, bool sorted) : sorted(sorted), cursors(store.runs.size() + 1) {
+            for (size_t i = 0; i < store.runs.size(); ++i) {
+                cursors[i].store = &store;
+                cursors[i].offset = store.runs[i].offset;
+                cursors[i].end = store.runs[i].offset + store.runs[i].bytes;
+                cursors[i].remaining = store.runs[i].cliques;
+            }
+            Cursor& memory = cursors.back();
+            memory.store = &store;
+            memory.in_memory = true;
+            memory.order.resize(store.buffer.num_cliques());
+            for (size_t i = 0; i < memory.order.size(); ++i) memory.order[i] = static_cast<uint32_t>(i);
+            if (sorted) {
+                store.sort_buffer_order(memory.order);
+                for (size_t i = 0; i < cursors.size(); ++i) {
+                    if (cursors[i].advance()) heap.push_back(i);
+                }
+                std::make_heap(heap.begin(), heap.end(), HeadGreater{this});
+            }
+        }
+
+    };
+
+    /**
+     * @brief Returns a reader over every clique added so far.
+     * @param sorted Whether to merge the runs into canonical order. Otherwise the runs are read one
+     *               after another, each sorted, followed by the buffer in insertion order.
+     * @note Time Complexity: O(c log r) to read c cliques from r runs when sorted, O(c) otherwise,
+     *       plus sorting the buffer.
+     */
+    Reader reader(bool sorted = true) const {
+        return Reader(*this, sorted);
+    }
+
+    /**
+     * @brief Calls f(clique) for every clique, as a vector of increasing vertex ids.
+     * @param sorted Whether to visit the cliques in canonical order.
+     */
+    template <typename F>
+    void for_each(F&& f, bool sorted = true) const {
+        Reader r = reader(sorted);
+        std::vector<int> clique;
+        while (r.next(clique)) f(clique);
+    }
+
+private:
+    // Cliques flattened: clique i is members[offsets[i]] .. members[offsets[i + 1] - 1].
+    struct Buffer {
+        std::vector<uint32_t> offsets{0};
+        std::vector<int> members;
+
+        size_t num_cliques() const {
+            return offsets.size() - 1;
+        }
+
+        size_t bytes() const {
+            return offsets.capacity() * sizeof(uint32_t) + members.capacity() * sizeof(int);
+        }
+    };
+
+    struct Run {
+        uint64_t offset;
+        uint64_t bytes;
+        size_t cliques;
+    };
+
+    size_t buffer_limit;
+    std::string directory;
+    std::mutex store_mutex;
+    Buffer buffer;
+    size_t total = 0;
+    std::vector<Run> runs;
+    int fd = -1;
+    uint64_t file_size = 0;
+    MemoryBudget* memory;
+    // The buffer bytes accounted to 'memory'.
+    size_t charged = 0;
+
+    // Accounts the buffer's current size and returns the change to apply to the budget. The budget
+    // is charged outside the lock, so an on_exceeded handler may spill this store.
+    long long recharge_locked() {
+        if (!memory) return 0;
+        long long change = static_cast<long long>(buffer.bytes()) - static_cast<long long>(charged);
+        charged = buffer.bytes();
+        return change;
+    }
+
+    void apply_charge(long long change) {
+        if (change > 0) {
+            memory->charge(static_cast<size_t>(change));
+        } else if (change < 0) {
+            memory->release(static_cast<size_t>(-change));
+        }
+    }
+
+    // Sorts the indices of buffered cliques into canonical order.
+    void sort_buffer_order(std::vector<uint32_t>& order) const {
+        const Buffer& b = buffer;
+        std::sort(order.begin(), order.end(), [&b](uint32_t x, uint32_t y) {
+            return std::lexicographical_compare(b.members.begin() + b.offsets[x], b.members.begin() + b.offsets[x + 1],
+                                                b.members.begin() + b.offsets[y], b.members.begin() + b.offsets[y + 1]);
+        });
+    }
+
+    static void write_varint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    size_t spill_locked() {
+        size_t n = buffer.num_cliques();
+        if (n == 0) return 0;
+        open_file();
+        std::vector<uint32_t> order(n);
+        for (size_t i = 0; i < n; ++i) order[i] = static_cast<uint32_t>(i);
+        sort_buffer_order(order);
+        std::vector<uint8_t> encoded;
+        encoded.reserve(buffer.members.size() + 2 * n);
+        const int* previous = nullptr;
+        size_t previous_size = 0;
+        for (uint32_t i : order) {
+            const int* clique = buffer.members.data() + buffer.offsets[i];
+            size_t size = buffer.offsets[i + 1] - buffer.offsets[i];
+            size_t shared = 0;
+            while (shared < size && shared < previous_size && clique[shared] == previous[shared]) shared++;
+            write_varint(encoded, shared);
+            write_varint(encoded, size - shared);
+            int last = shared > 0 ? clique[shared - 1] : -1;
+            for (size_t k = shared; k < size; ++k) {
+                write_varint(encoded, static_cast<uint64_t>(clique[k] - last - 1));
+                last = clique[k];
+            }
+            previous = clique;
+            previous_size = size;
+        }
+        write_at(encoded.data(), encoded.size(), file_size);
+        runs.push_back(Run{file_size, encoded.size(), n});
+        file_size += encoded.size();
+        size_t freed = buffer.bytes();
+        buffer = Buffer();
+        return freed;
+    }
+
+    void open_file() {
+        if (fd >= 0) return;
+        std::string path = directory + "/clique_store_XXXXXX";
+        std::vector<char> name(path.begin(), path.end());
+        name.push_back('\0');
+        fd = mkstemp(name.data());
+        if (fd < 0) throw std::runtime_error("clique store: cannot create " + path + ": " + std::strerror(errno));
+        unlink(name.data());
+    }
+
+    void write_at(const uint8_t* data, size_t length, uint64_t offset) {
+        while (length > 0) {
+            ssize_t written = pwrite(fd, data, length, static_cast<off_t>(offset));
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("clique store: write failed: ") + std::strerror(errno));
+            }
+            data += written;
+            length -= static_cast<size_t>(written);
+            offset += static_cast<uint64_t>(written);
+        }
+    }
+
+    void read_at(uint8_t* data, size_t length, uint64_t offset) const {
+        while (length > 0) {
+            ssize_t got = pread(fd, data, length, static_cast<off_t>(offset));
+            if (got <= 0) {
+                if (got < 0 && errno == EINTR) continue;
+                throw std::runtime_error("clique store: read failed");
+            }
+            data += got;
+            length -= static_cast<size_t>(got);
+            offset += static_cast<uint64_t>(got);
+        }
+    }
+};
+
+#endif  // CLIQUE_STORE_H
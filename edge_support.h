@@ -0,0 +1,278 @@
+#ifndef EDGE_SUPPORT_H
+#define EDGE_SUPPORT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bron_kerbosch.h"
+#include "sorted_vertex_set.h"
+#include "sparse_engine.h"
+
+// The vertex of P or X on the most triangles, a denser-neighborhood variant of MaxDegreePivot. Its
+// triangle counts are shared between copies, so copying it per task or per worker is cheap.
+struct TrianglePivot {
+    std::shared_ptr<const std::vector<long long>> triangles;
+
+    int select(const PivotView&, const std::set<int>& P, const std::set<int>& X) {
+        const std::vector<long long>& t = *triangles;
+        int u = *P.begin();
+        for (int v : P) {
+            if (t[v] > t[u]) u = v;
+        }
+        for (int v : X) {
+            if (t[v] > t[u]) u = v;
+        }
+        return u;
+    }
+};
+
+/**
+ * @brief The support of every edge of a graph: the number of triangles it lies on.
+ * @brief An edge on no triangle is a maximal clique of two vertices by itself, and every edge of a
+ *        clique of k vertices lies on at least k - 2 triangles within it. So the edges of the
+ *        maximal cliques with at least k >= 3 vertices all belong to the k-truss, the largest
+ *        subgraph whose every edge lies on k - 2 of its triangles. A clique of k or more vertices
+ *        is maximal in the graph exactly when it is maximal in the k-truss, so those cliques can be
+ *        searched for in the k-truss alone.
+ *
+ *        The supports are counted once, on several threads, by intersecting the two endpoints'
+ *        neighborhoods: as bitset rows when the graph is dense, with the sorted-array kernels of
+ *        namespace intersection otherwise.
+ */
+class EdgeSupport {
+public:
+    int num_vertices;
+
+    /**
+     * @brief Counts the triangles on every edge of g.
+     * @param g The graph.
+     * @param num_threads The number of threads; the vertices are handed out to them one at a time.
+     * @note Time Complexity: O(sum over the edges uv of min(deg(u) + deg(v), n / 64)).
+     */
+    explicit EdgeSupport(const Graph& g, int num_threads = 1) : num_vertices(g.num_vertices) {
+        CsrAdjacency adjacency(g);
+        offsets = std::move(adjacency.offsets);
+        targets = std::move(adjacency.targets);
+        supports.assign(targets.size(), 0);
+        size_t words = (static_cast<size_t>(num_vertices) + 63) / 64;
+
+        // Every edge uv with u < v is counted by the thread that takes u.
+        std::atomic<int> next_vertex{0};
+        auto worker = [&] {
+            for (int u; (u = next_vertex.fetch_add(1)) < num_vertices;) {
+                for (int i = offsets[u]; i < offsets[u + 1]; ++i) {
+                    int v = targets[i];
+                    if (v < u) continue;
+                    if (words <= static_cast<size_t>(degree(u) + degree(v))) {
+                        const uint64_t* a = g.adj_bits[u].data();
+                        const uint64_t* b = g.adj_bits[v].data();
+                        int count = 0;
+                        for (size_t w = 0; w < words; ++w) count += __builtin_popcountll(a[w] & b[w]);
+                        supports[i] = count;
+                    } else {
+                        supports[i] = static_cast<int>(
+                            intersection::count(neighbors(u), degree(u), neighbors(v), degree(v)));
+                    }
+                }
+            }
+        };
+        if (num_threads <= 1) {
+            worker();
+        } else {
+            std::vector<std::thread> threads;
+            for (int t = 0; t < num_threads; ++t) {
+                threads.emplace_back(worker);
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+        }
+        // Copy every count to the edge's other direction.
+        for (int v = 0; v < num_vertices; ++v) {
+            for (int i = offsets[v]; i < offsets[v + 1]; ++i) {
+                int u = targets[i];
+                if (u < v) supports[i] = supports[index_of(u, v)];
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the number of triangles on the edge uv, or -1 if u and v are not adjacent.
+     * @note Time Complexity: O(log deg(u)).
+     */
+    int support(int u, int v) const {
+        int i = index_of(u, v);
+        return i < 0 ? -1 : supports[i];
+    }
+
+    /**
+     * @brief Returns the number of triangles through every vertex.
+     */
+    std::vector<long long> vertex_triangles() const {
+        std::vector<long long> result(num_vertices, 0);
+        for (int v = 0; v < num_vertices; ++v) {
+            for (int i = offsets[v]; i < offsets[v + 1]; ++i) result[v] += supports[i];
+            // Each triangle through v is counted on both of its edges at v.
+            result[v] /= 2;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns the number of triangles of the graph.
+     */
+    long long num_triangles() const {
+        long long total = 0;
+        for (int s : supports) total += s;
+        // Each triangle is counted on its three edges, in both directions.
+        return total / 6;
+    }
+
+    /**
+     * @brief Returns a TrianglePivot over the triangle counts of this graph.
+     */
+    TrianglePivot triangle_pivot() const {
+        return TrianglePivot{std::make_shared<const std::vector<long long>>(vertex_triangles())};
+    }
+
+    /**
+     * @brief Returns the edges of the k-truss, as pairs (u, v) with u < v.
+     * @brief Edges on fewer than k - 2 triangles are peeled one at a time; removing an edge takes one
+     *        triangle from each of the two other edges of every triangle it was on, which may in turn
+     *        bring them below k - 2.
+     * @param k The truss order; k <= 2 keeps every edge.
+     * @note Time Complexity: O(m + sum over the peeled edges uv of deg(u) + deg(v)).
+     */
+    std::vector<std::pair<int, int>> truss_edges(int k) const {
+        std::vector<int> remaining = supports;
+        std::vector<char> removed(targets.size(), 0);
+        // Edges to peel, as a vertex u and the index of the edge in u's neighborhood.
+        std::vector<std::pair<int, int>> queue;
+        for (int u = 0; u < num_vertices; ++u) {
+            for (int i = offsets[u]; i < offsets[u + 1]; ++i) {
+                if (targets[i] > u && remaining[i] < k - 2) queue.push_back({u, i});
+            }
+        }
+        // Takes one triangle from the edge at index i of u's neighborhood and from its reverse.
+        auto weaken = [&](int u, int i) {
+            if (--remaining[i] == k - 3) queue.push_back({u, i});
+            --remaining[index_of(targets[i], u)];
+        };
+        for (size_t q = 0; q < queue.size(); ++q) {
+            int u = queue[q].first, e = queue[q].second;
+            int v = targets[e];
+            int r = index_of(v, u);
+            removed[e] = removed[r] = 1;
+            // Walk the common neighbors w; the triangle uvw still stands if uw and vw do.
+            int i = offsets[u], j = offsets[v];
+            while (i < offsets[u + 1] && j < offsets[v + 1]) {
+                if (targets[i] < targets[j]) {
+                    ++i;
+                } else if (targets[j] < targets[i]) {
+                    ++j;
+                } else {
+                    if (!removed[i] && !removed[j]) {
+                        weaken(u, i);
+                        weaken(v, j);
+                    }
+                    ++i;
+                    ++j;
+                }
+            }
+        }
+        std::vector<std::pair<int, int>> edges;
+        for (int u = 0; u < num_vertices; ++u) {
+            for (int i = offsets[u]; i < offsets[u + 1]; ++i) {
+                if (targets[i] > u && !removed[i]) edges.push_back({u, targets[i]});
+            }
+        }
+        return edges;
+    }
+
+    /**
+     * @brief Returns the k-truss as a graph on the same vertices.
+     */
+    Graph truss(int k) const {
+        Graph result(num_vertices);
+        for (const auto& e : truss_edges(k)) {
+            result.add_edge(e.first, e.second);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Streams the maximal cliques of the graph the supports were counted on, using them to
+     *        shrink the search.
+     * @brief Isolated vertices and the edges on no triangle are reported directly, and the cliques
+     *        with at least max(3, min_size) vertices are searched for in that order's truss, with the
+     *        parallel search of Graph. Searches truncated below 3 vertices (max_size < 3) gain
+     *        nothing and run on the whole graph.
+     * @param on_clique Called once per reported clique. Called from the calling thread for the
+     *                  cliques reported directly, then as by Graph::for_each_max_clique_parallel.
+     * @param num_threads The number of worker threads of the search.
+     * @param options The search options; they apply to the cliques reported directly too.
+     * @param stats Receives the counters of the search, plus the cliques reported directly.
+     * @param pivot The pivot policy; triangle_pivot() is one seeded by the supports.
+     */
+    template <typename PivotPolicy = TomitaPivot>
+    void for_each_max_clique(const CliqueCallback& on_clique, int num_threads, const CliqueSearchOptions& options,
+                             CliqueSearchStats& stats, PivotPolicy pivot = PivotPolicy()) const {
+        if (options.max_size < 3) {
+            Graph whole = truss(2);
+            whole.for_each_max_clique_parallel(on_clique, num_threads, options, stats, pivot);
+            return;
+        }
+        long long direct = 0;
+        if (options.min_size <= 2) {
+            for (int u = 0; u < num_vertices; ++u) {
+                if (offsets[u] == offsets[u + 1] && options.min_size <= 1) {
+                    on_clique(std::set<int>{u});
+                    direct++;
+                }
+                for (int i = offsets[u]; i < offsets[u + 1]; ++i) {
+                    if (targets[i] > u && supports[i] == 0) {
+                        on_clique(std::set<int>{u, targets[i]});
+                        direct++;
+                    }
+                }
+            }
+        }
+        CliqueSearchOptions truss_options = options;
+        truss_options.min_size = std::max(3, options.min_size);
+        Graph reduced = truss(truss_options.min_size);
+        reduced.for_each_max_clique_parallel(on_clique, num_threads, truss_options, stats, pivot);
+        stats.cliques += direct;
+    }
+
+private:
+    // Neighbors of v, sorted: targets[offsets[v]] .. targets[offsets[v + 1] - 1], and the support of
+    // each of those edges at the same index.
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<int> supports;
+
+    int degree(int v) const {
+        return offsets[v + 1] - offsets[v];
+    }
+
+    const int* neighbors(int v) const {
+        return targets.data() + offsets[v];
+    }
+
+    // The index of the edge uv in targets, or -1.
+    int index_of(int u, int v) const {
+        const int* begin = neighbors(u);
+        const int* end = begin + degree(u);
+        const int* it = std::lower_bound(begin, end, v);
+        return it != end && *it == v ? static_cast<int>(it - targets.data()) : -1;
+    }
+};
+
+#endif  // EDGE_SUPPORT_H
@@ -0,0 +1,67 @@
+#ifndef GRAPH_GENERATORS_H
+#define GRAPH_GENERATORS_H
+
+#include "bron_kerbosch.h"
+
+// Erdos-Renyi G(n, p) graph.
+inline Graph make_random_graph(int n, double p, unsigned seed) {
+    Graph g(n);
+    // Small linear congruential generator so the test graphs are identical on every platform.
+    unsigned state = seed;
+    for (int u = 0; u < n; ++u) {
+        for (int v = u + 1; v < n; ++v) {
+            state = state * 1103515245u + 12345u;
+            if ((state >> 8) % 1000 < p * 1000) {
+                g.add_edge(u, v);
+            }
+        }
+    }
+    return g;
+}
+
+// Complete multipartite graph with k parts of size 3, which has the maximum possible 3^k maximal cliques.
+inline Graph make_moon_moser_graph(int k) {
+    Graph g(3 * k);
+    for (int u = 0; u < 3 * k; ++u) {
+        for (int v = u + 1; v < 3 * k; ++v) {
+            if (u / 3 != v / 3) {
+                g.add_edge(u, v);
+            }
+        }
+    }
+    return g;
+}
+
+// Scale-free graph with social-network-like clustering (Holme-Kim): each new vertex attaches to
+// 'edges_per_vertex' existing vertices by preferential attachment, and after each attachment adds a
+// triangle-closing edge to a neighbor of that vertex with probability 'triad_probability'.
+inline Graph make_social_graph(int n, int edges_per_vertex, double triad_probability, unsigned seed) {
+    Graph g(n);
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    // Every edge endpoint appears once here, so a uniform pick is proportional to degree.
+    std::vector<int> endpoints;
+    std::vector<std::vector<int>> neighbors(n);
+    auto connect = [&](int u, int v) {
+        if (u == v || g.adj_matrix[u][v]) return false;
+        g.add_edge(u, v);
+        endpoints.push_back(u);
+        endpoints.push_back(v);
+        neighbors[u].push_back(v);
+        neighbors[v].push_back(u);
+        return true;
+    };
+    for (int v = 1; v < n; ++v) {
+        for (int k = 0; k < edges_per_vertex; ++k) {
+            int target = endpoints.empty() ? static_cast<int>(rng() % v)
+                                           : endpoints[rng() % endpoints.size()];
+            if (!connect(v, target)) continue;
+            if (coin(rng) < triad_probability && neighbors[target].size() > 1) {
+                connect(v, neighbors[target][rng() % neighbors[target].size()]);
+            }
+        }
+    }
+    return g;
+}
+
+#endif  // GRAPH_GENERATORS_H
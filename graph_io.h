@@ -0,0 +1,257 @@
+#ifndef GRAPH_IO_H
+#define GRAPH_IO_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <istream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bron_kerbosch.h"
+
+// Supported graph file formats.
+enum class GraphFormat {
+    EdgeList,      // One "u v" pair per line, 0-based; '#' and '%' start comment lines.
+    Dimacs,        // "p edge n m" header and "e u v" lines, 1-based; 'c' starts comment lines.
+    Metis,         // "n m [fmt]" header, then line i lists the 1-based neighbors of vertex i.
+    MatrixMarket,  // Coordinate matrix, 1-based "i j [value]" entries; the pattern is used as adjacency.
+};
+
+/**
+ * @brief Parses a format name ("edgelist", "dimacs", "metis" or "mtx").
+ * @return True if the name is known, in which case 'format' receives it.
+ */
+inline bool parse_graph_format(const std::string& name, GraphFormat& format) {
+    if (name == "edgelist" || name == "edges") {
+        format = GraphFormat::EdgeList;
+    } else if (name == "dimacs") {
+        format = GraphFormat::Dimacs;
+    } else if (name == "metis") {
+        format = GraphFormat::Metis;
+    } else if (name == "mtx" || name == "matrixmarket") {
+        format = GraphFormat::MatrixMarket;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Guesses the format of a graph file from its extension; unknown extensions are edge lists.
+ */
+inline GraphFormat graph_format_for_path(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    std::string ext = dot == std::string::npos ? "" : path.substr(dot + 1);
+    if (ext == "dimacs" || ext == "clq" || ext == "col") return GraphFormat::Dimacs;
+    if (ext == "graph" || ext == "metis") return GraphFormat::Metis;
+    if (ext == "mtx") return GraphFormat::MatrixMarket;
+    return GraphFormat::EdgeList;
+}
+
+namespace graph_io_detail {
+
+// Parses the whitespace-separated integers of a line, starting at 'pos'.
+inline std::vector<long long> parse_integers(const std::string& line, size_t pos, int line_number) {
+    std::vector<long long> values;
+    const char* p = line.c_str() + pos;
+    while (true) {
+        while (*p == ' ' || *p == '\t' || *p == '\r') ++p;
+        if (*p == '\0') break;
+        char* end;
+        long long value = std::strtoll(p, &end, 10);
+        if (end == p) {
+            // Trailing non-integer fields (weights, values) are ignored.
+            if (!values.empty()) break;
+            throw std::runtime_error("line " + std::to_string(line_number) + ": expected an integer");
+        }
+        values.push_back(value);
+        p = end;
+    }
+    return values;
+}
+
+inline Graph build_graph(long long num_vertices, const std::vector<std::pair<int, int>>& edges) {
+    Graph g(static_cast<int>(num_vertices));
+    for (const auto& e : edges) {
+        // Self-loops never matter for cliques.
+        if (e.first != e.second) {
+            g.add_edge(e.first, e.second);
+        }
+    }
+    return g;
+}
+
+inline void check_vertex(long long v, long long num_vertices, int line_number) {
+    if (v < 0 || v >= num_vertices) {
+        throw std::runtime_error("line " + std::to_string(line_number) + ": vertex out of range");
+    }
+}
+
+}  // namespace graph_io_detail
+
+// The vertex count and edges of a graph file, as read, before any adjacency structure is built.
+struct GraphEdges {
+    int num_vertices = 0;
+    // May contain self-loops and parallel edges.
+    std::vector<std::pair<int, int>> edges;
+};
+
+/**
+ * @brief Reads the edges of a graph in the given format, without building a Graph.
+ * @brief Engines with their own adjacency structure (e.g. SparseCliqueEngine) start from this,
+ *        since Graph needs quadratic memory in the number of vertices.
+ * @param in The input stream.
+ * @param format The file format.
+ * @throws std::runtime_error On malformed input, with the offending line number.
+ */
+inline GraphEdges read_graph_edges(std::istream& in, GraphFormat format) {
+    using namespace graph_io_detail;
+    std::vector<std::pair<int, int>> edges;
+    long long num_vertices = -1;
+    long long metis_vertex = 0;
+    bool mtx_size_seen = false;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(in, line)) {
+        line_number++;
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos) {
+            // An empty METIS line is a vertex without neighbors.
+            if (format == GraphFormat::Metis && num_vertices >= 0) metis_vertex++;
+            continue;
+        }
+        char first = line[start];
+        switch (format) {
+            case GraphFormat::EdgeList: {
+                if (first == '#' || first == '%') continue;
+                std::vector<long long> fields = parse_integers(line, start, line_number);
+                if (fields.size() < 2) {
+                    throw std::runtime_error("line " + std::to_string(line_number) + ": expected an edge");
+                }
+                check_vertex(fields[0], 1LL << 30, line_number);
+                check_vertex(fields[1], 1LL << 30, line_number);
+                edges.push_back({static_cast<int>(fields[0]), static_cast<int>(fields[1])});
+                num_vertices = std::max(num_vertices, std::max(fields[0], fields[1]) + 1);
+                break;
+            }
+            case GraphFormat::Dimacs: {
+                if (first == 'c') continue;
+                if (first == 'p') {
+                    size_t numbers = line.find_first_of("0123456789", start);
+                    std::vector<long long> fields =
+                        numbers == std::string::npos ? std::vector<long long>() : parse_integers(line, numbers, line_number);
+                    if (fields.size() < 2) {
+                        throw std::runtime_error("line " + std::to_string(line_number) + ": malformed problem line");
+                    }
+                    num_vertices = fields[0];
+                } else if (first == 'e') {
+                    if (num_vertices < 0) {
+                        throw std::runtime_error("line " + std::to_string(line_number) + ": edge before problem line");
+                    }
+                    std::vector<long long> fields = parse_integers(line, start + 1, line_number);
+                    if (fields.size() < 2) {
+                        throw std::runtime_error("line " + std::to_string(line_number) + ": expected an edge");
+                    }
+                    check_vertex(fields[0] - 1, num_vertices, line_number);
+                    check_vertex(fields[1] - 1, num_vertices, line_number);
+                    edges.push_back({static_cast<int>(fields[0] - 1), static_cast<int>(fields[1] - 1)});
+                } else {
+                    throw std::runtime_error("line " + std::to_string(line_number) + ": unknown DIMACS line");
+                }
+                break;
+            }
+            case GraphFormat::Metis: {
+                if (first == '%') continue;
+                std::vector<long long> fields = parse_integers(line, start, line_number);
+                if (num_vertices < 0) {
+                    if (fields.size() < 2) {
+                        throw std::runtime_error("line " + std::to_string(line_number) + ": malformed header");
+                    }
+                    if (fields.size() >= 3 && fields[2] != 0) {
+                        throw std::runtime_error("weighted METIS graphs are not supported");
+                    }
+                    num_vertices = fields[0];
+                    continue;
+                }
+                check_vertex(metis_vertex, num_vertices, line_number);
+                for (long long neighbor : fields) {
+                    check_vertex(neighbor - 1, num_vertices, line_number);
+                    edges.push_back({static_cast<int>(metis_vertex), static_cast<int>(neighbor - 1)});
+                }
+                metis_vertex++;
+                break;
+            }
+            case GraphFormat::MatrixMarket: {
+                if (first == '%') continue;
+                std::vector<long long> fields = parse_integers(line, start, line_number);
+                if (fields.size() < 2) {
+                    throw std::runtime_error("line " + std::to_string(line_number) + ": expected an entry");
+                }
+                if (!mtx_size_seen) {
+                    num_vertices = std::max(fields[0], fields[1]);
+                    mtx_size_seen = true;
+                    continue;
+                }
+                check_vertex(fields[0] - 1, num_vertices, line_number);
+                check_vertex(fields[1] - 1, num_vertices, line_number);
+                edges.push_back({static_cast<int>(fields[0] - 1), static_cast<int>(fields[1] - 1)});
+                break;
+            }
+        }
+    }
+    GraphEdges result;
+    result.num_vertices = static_cast<int>(std::max(num_vertices, 0LL));
+    result.edges = std::move(edges);
+    return result;
+}
+
+/**
+ * @brief Builds a Graph from edges read by read_graph_edges. Self-loops are dropped and parallel edges merged.
+ */
+inline Graph make_graph(const GraphEdges& graph_edges) {
+    return graph_io_detail::build_graph(graph_edges.num_vertices, graph_edges.edges);
+}
+
+/**
+ * @brief Reads a graph in the given format.
+ * @param in The input stream.
+ * @param format The file format.
+ * @return The graph. Self-loops are dropped and parallel edges merged.
+ * @throws std::runtime_error On malformed input, with the offending line number.
+ */
+inline Graph read_graph(std::istream& in, GraphFormat format) {
+    return make_graph(read_graph_edges(in, format));
+}
+
+/**
+ * @brief Reads a graph file; the format defaults to the one implied by the file extension.
+ * @throws std::runtime_error If the file cannot be opened or is malformed.
+ */
+inline Graph read_graph_file(const std::string& path, GraphFormat format) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    return read_graph(file, format);
+}
+
+/**
+ * @brief Reads the edges of a graph file, as read_graph_edges does.
+ * @throws std::runtime_error If the file cannot be opened or is malformed.
+ */
+inline GraphEdges read_graph_edges_file(const std::string& path, GraphFormat format) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot open " + path);
+    }
+    return read_graph_edges(file, format);
+}
+
+inline Graph read_graph_file(const std::string& path) {
+    return read_graph_file(path, graph_format_for_path(path));
+}
+
+#endif  // GRAPH_IO_H
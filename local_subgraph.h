@@ -0,0 +1,181 @@
+#ifndef LOCAL_SUBGRAPH_H
+#define LOCAL_SUBGRAPH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "bron_kerbosch.h"
+#include "sorted_vertex_set.h"
+#include "sparse_engine.h"
+
+/**
+ * @brief The subgraph induced by a list of vertices, relabeled 0 .. size() - 1 in the order of the
+ *        list. Its adjacency is kept as bitset rows, as a small CSR array, or both.
+ */
+struct LocalSubgraph {
+    enum Layout { Bitset = 1, Csr = 2, Both = 3 };
+
+    // The global id of every local vertex.
+    std::vector<int> vertices;
+    // With an ego network, the local vertices 0 .. num_later - 1 come after the center in the
+    // ordering and the rest before it; otherwise num_later is size().
+    int num_later = 0;
+    // Bitset rows of 'words' 64-bit words each: row i is bits[i * words] .. bits[(i + 1) * words - 1].
+    size_t words = 0;
+    std::vector<uint64_t> bits;
+    // Sorted local neighbors of local vertex i: targets[offsets[i]] .. targets[offsets[i + 1] - 1].
+    std::vector<int> offsets;
+    std::vector<int> targets;
+
+    int size() const {
+        return static_cast<int>(vertices.size());
+    }
+
+    /**
+     * @brief Returns the bitset row of local vertex i; needs the Bitset layout.
+     */
+    const uint64_t* row(int i) const {
+        return bits.data() + i * words;
+    }
+
+    /**
+     * @brief Returns whether local vertices i and j are adjacent; needs the Bitset layout.
+     */
+    bool adjacent(int i, int j) const {
+        return (row(i)[j / 64] >> (j % 64)) & 1;
+    }
+
+    /**
+     * @brief Returns the number of local neighbors of local vertex i; needs the Csr layout.
+     */
+    int degree(int i) const {
+        return offsets[i + 1] - offsets[i];
+    }
+
+    /**
+     * @brief Returns the sorted local neighbors of local vertex i; needs the Csr layout.
+     */
+    const int* neighbors(int i) const {
+        return targets.data() + offsets[i];
+    }
+
+    /**
+     * @brief Returns the number of edges of the subgraph.
+     */
+    long long num_edges() const {
+        long long total = 0;
+        if (!offsets.empty()) {
+            total = static_cast<long long>(targets.size());
+        } else {
+            for (uint64_t word : bits) total += __builtin_popcountll(word);
+        }
+        return total / 2;
+    }
+};
+
+/**
+ * @brief Builds induced subgraphs of a CsrAdjacency, relabeled to local ids.
+ * @brief The neighborhood of every vertex of the list is intersected with the list, sorted by
+ *        global id, using the adaptive kernels of namespace intersection: galloping for hubs whose
+ *        neighborhood is much longer than the list, SIMD blocks or a branch-free merge otherwise.
+ *        The common vertices are mapped to local ids through an array indexed by global id, which
+ *        is set for the list's vertices only and cleared after every call.
+ *
+ *        An extractor keeps its buffers from one call to the next, so a loop over many vertices
+ *        allocates nothing once they have grown. It is not thread-safe: use one per thread.
+ */
+class LocalSubgraphExtractor {
+public:
+    explicit LocalSubgraphExtractor(const CsrAdjacency& adjacency)
+        : adjacency(adjacency), local_id(adjacency.num_vertices, -1) {}
+
+    /**
+     * @brief Extracts the subgraph induced by a list of distinct vertices.
+     * @param vertices The vertices, in the order of their local ids.
+     * @param out Receives the subgraph; its buffers are reused.
+     * @param layout The adjacency representations to build.
+     * @note Time Complexity: O(sum over the list of min(deg(u) + k, k log deg(u)) + k^2 / 64) for a
+     *       list of k vertices.
+     */
+    void extract(const std::vector<int>& vertices, LocalSubgraph& out,
+                 LocalSubgraph::Layout layout = LocalSubgraph::Bitset) {
+        sorted.assign(vertices.begin(), vertices.end());
+        std::sort(sorted.begin(), sorted.end());
+        out.vertices.assign(vertices.begin(), vertices.end());
+        out.num_later = out.size();
+        build(out, layout, sorted.data());
+    }
+
+    /**
+     * @brief Extracts the ego network of v: the subgraph induced by its neighbors, without v. The
+     *        neighbors after v in the ordering come first, as a degeneracy-ordered search wants its
+     *        candidates P, followed by those before it, the excluded X.
+     * @param v The center vertex.
+     * @param position The index of every vertex in the ordering, e.g. of degeneracy_ordering; empty
+     *                 orders the vertices by id.
+     * @param out Receives the subgraph, with out.num_later = |P|; its buffers are reused.
+     * @param layout The adjacency representations to build.
+     * @note Time Complexity: as extract, for the deg(v) neighbors of v; no sorting is needed.
+     */
+    void extract_ego(int v, const std::vector<int>& position, LocalSubgraph& out,
+                     LocalSubgraph::Layout layout = LocalSubgraph::Bitset) {
+        const int* begin = adjacency.neighbors(v);
+        const int* end = begin + adjacency.degree(v);
+        out.vertices.clear();
+        auto later = [&](int u) { return position.empty() ? u > v : position[u] > position[v]; };
+        for (const int* u = begin; u != end; ++u) {
+            if (later(*u)) out.vertices.push_back(*u);
+        }
+        out.num_later = out.size();
+        for (const int* u = begin; u != end; ++u) {
+            if (!later(*u)) out.vertices.push_back(*u);
+        }
+        build(out, layout, begin);
+    }
+
+private:
+    const CsrAdjacency& adjacency;
+    // The local id of every vertex of the current list, -1 for the others.
+    std::vector<int> local_id;
+    // A list sorted by global id, for extract, and the intersection of one neighborhood with the list.
+    std::vector<int> sorted;
+    std::vector<int> common;
+
+    // Fills the adjacency of out.vertices, given the same vertices sorted by global id.
+    void build(LocalSubgraph& out, LocalSubgraph::Layout layout, const int* by_id) {
+        int k = out.size();
+        for (int i = 0; i < k; ++i) local_id[out.vertices[i]] = i;
+        bool with_bits = layout & LocalSubgraph::Bitset, with_csr = layout & LocalSubgraph::Csr;
+        out.words = (static_cast<size_t>(k) + 63) / 64;
+        out.bits.assign(with_bits ? k * out.words : 0, 0);
+        out.offsets.clear();
+        out.targets.clear();
+        if (with_csr) out.offsets.push_back(0);
+        common.resize(k);
+        for (int i = 0; i < k; ++i) {
+            int u = out.vertices[i];
+            size_t found =
+                intersection::adaptive(adjacency.neighbors(u), adjacency.degree(u), by_id, k, common.data());
+            if (with_bits) {
+                uint64_t* row = out.bits.data() + i * out.words;
+                for (size_t t = 0; t < found; ++t) {
+                    int j = local_id[common[t]];
+                    row[j / 64] |= uint64_t(1) << (j % 64);
+                }
+            }
+            if (with_csr) {
+                size_t start = out.targets.size();
+                for (size_t t = 0; t < found; ++t) out.targets.push_back(local_id[common[t]]);
+                // The common vertices are sorted by global id, not necessarily by local id.
+                std::sort(out.targets.begin() + start, out.targets.end());
+                out.offsets.push_back(static_cast<int>(out.targets.size()));
+            }
+        }
+        for (int u : out.vertices) local_id[u] = -1;
+    }
+};
+
+#endif  // LOCAL_SUBGRAPH_H
@@ -0,0 +1,285 @@
+#ifndef PARTITION_ENGINE_H
+#define PARTITION_ENGINE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "bron_kerbosch.h"
+#include "sparse_engine.h"
+
+/**
+ * @brief Bron-Kerbosch engine that keeps P and X as adjacent ranges of one vertex array
+ *        (Eppstein, Loffler and Strash).
+ * @brief Every worker owns a permutation of the vertices and the index of every vertex in it. A
+ *        subproblem is three indices: X is [begin_x, begin_p) and P is [begin_p, end_p). A child's
+ *        sets are built by swapping the neighbors of the branch vertex to the inner ends of both
+ *        ranges, so the child's X and P are again adjacent ranges, inside the parent's. Moving a
+ *        vertex from P to X is one swap and an increment of begin_p. Before returning, a call swaps
+ *        the vertices it moved back to P, which restores its caller's ranges in O(changes).
+ *        Nothing is allocated once the per-worker buffers have grown.
+ *
+ *        Neighborhoods are stored as one CSR array. The outer loop visits the vertices in
+ *        degeneracy order, and below it the search uses Tomita pivoting, as in SparseCliqueEngine.
+ */
+class PartitionCliqueEngine {
+public:
+    int num_vertices;
+
+    /**
+     * @brief Builds the engine from an edge list. Self-loops and parallel edges are ignored.
+     * @param n The number of vertices.
+     * @param edges The edges, as pairs of vertex ids in [0, n).
+     * @note Time Complexity: O(n + m log m) for m edges.
+     */
+    PartitionCliqueEngine(int n, const std::vector<std::pair<int, int>>& edges) : num_vertices(n) {
+        build(CsrAdjacency(n, edges));
+    }
+
+    /**
+     * @brief Builds the engine from the adjacency of a Graph.
+     */
+    explicit PartitionCliqueEngine(const Graph& g) : num_vertices(g.num_vertices) {
+        build(CsrAdjacency(g));
+    }
+
+    /**
+     * @brief Returns the number of neighbors of vertex v.
+     */
+    int degree(int v) const {
+        return offsets[v + 1] - offsets[v];
+    }
+
+    /**
+     * @brief Returns the degeneracy of the graph: the largest core number of any vertex.
+     */
+    int degeneracy() const {
+        return core.empty() ? 0 : *std::max_element(core.begin(), core.end());
+    }
+
+    /**
+     * @brief Returns the number of bytes used by the neighborhoods.
+     */
+    size_t memory_bytes() const {
+        return offsets.capacity() * sizeof(int) + targets.capacity() * sizeof(int);
+    }
+
+    /**
+     * @brief Streams the maximal cliques to a callback, with the semantics of
+     *        SparseCliqueEngine::for_each_max_clique.
+     * @param on_clique Called once per reported clique. With several threads the calls are
+     *                  serialized by an internal lock but come in no particular order; with
+     *                  options.deterministic they come in the order of the one-thread search.
+     * @param options The size bounds, memory budget and output order of the search; the coloring
+     *                bound, vertex ordering and progress reporting are not supported.
+     * @param stats Receives the instrumentation counters, summed over the workers.
+     * @param num_threads The number of worker threads. Each holds two arrays of num_vertices ints.
+     */
+    void for_each_max_clique(const CliqueCallback& on_clique, const CliqueSearchOptions& options,
+                             CliqueSearchStats& stats, int num_threads = 1) {
+        stats = CliqueSearchStats();
+        if (num_vertices == 0 || options.max_size < 1 || options.min_size > options.max_size) {
+            return;
+        }
+        MemoryBudget local_budget;
+        MemoryBudget* memory = options.memory ? options.memory : &local_budget;
+        // The permutation and index arrays of every worker.
+        ScopedMemoryCharge buffers_charge(memory, static_cast<size_t>(std::max(1, num_threads)) * 2 * num_vertices *
+                                                      sizeof(int));
+        if (!buffers_charge.ok()) {
+            record_memory_stats(*memory, stats);
+            return;
+        }
+        run_root_workers(order.size(), on_clique, stats, *memory, num_threads, options.deterministic,
+                         [&](const CliqueCallback& emit, CliqueSearchStats& worker_stats) {
+                             Search search{options, emit, worker_stats, memory, {}, {}, {}, {}};
+                             search.vertices.resize(num_vertices);
+                             search.index.resize(num_vertices);
+                             for (int v = 0; v < num_vertices; ++v) {
+                                 search.vertices[v] = v;
+                                 search.index[v] = v;
+                             }
+                             return [this, search = std::move(search)](size_t i) mutable {
+                                 expand_root(order[i], search);
+                             };
+                         });
+        record_memory_stats(*memory, stats);
+    }
+
+    /**
+     * @brief Finds all maximal cliques.
+     * @return A vector of sets, where each set represents a maximal clique.
+     */
+    std::vector<std::set<int>> find_max_cliques() {
+        std::vector<std::set<int>> cliques;
+        CliqueSearchStats stats;
+        for_each_max_clique([&](const std::set<int>& clique) { cliques.push_back(clique); }, CliqueSearchOptions(),
+                            stats);
+        return cliques;
+    }
+
+private:
+    // Neighbors of v, sorted: targets[offsets[v]] .. targets[offsets[v + 1] - 1].
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    // Vertices in degeneracy order, and the index of every vertex in it.
+    std::vector<int> order;
+    std::vector<int> position;
+    std::vector<int> core;
+
+    struct Search {
+        const CliqueSearchOptions& options;
+        const CliqueCallback& emit;
+        CliqueSearchStats& stats;
+        MemoryBudget* memory;
+        std::vector<int> R;
+        // The permutation holding the P and X ranges, and the index of every vertex in it.
+        std::vector<int> vertices;
+        std::vector<int> index;
+        // The branch vertices of every level of the recursion, stacked.
+        std::vector<int> branches;
+
+        void swap_to(int v, int i) {
+            int w = vertices[i];
+            std::swap(vertices[i], vertices[index[v]]);
+            std::swap(index[w], index[v]);
+        }
+    };
+
+    void build(CsrAdjacency csr) {
+        degeneracy_ordering(csr, order, core);
+        position.assign(num_vertices, 0);
+        for (int i = 0; i < num_vertices; ++i) position[order[i]] = i;
+        offsets = std::move(csr.offsets);
+        targets = std::move(csr.targets);
+    }
+
+    bool adjacent(int u, int v) const {
+        return std::binary_search(targets.begin() + offsets[u], targets.begin() + offsets[u + 1], v);
+    }
+
+    // The subproblem of vertex v: its later neighbors are candidates, its earlier ones excluded.
+    void expand_root(int v, Search& search) {
+        const CliqueSearchOptions& options = search.options;
+        int min_core = options.min_size - 1;
+        if (core[v] < min_core) {
+            search.stats.pruned++;
+            return;
+        }
+        int end_x = 0;
+        for (int i = offsets[v]; i < offsets[v + 1]; ++i) {
+            int u = targets[i];
+            if (core[u] >= min_core && position[u] < position[v]) search.swap_to(u, end_x++);
+        }
+        int end_p = end_x;
+        for (int i = offsets[v]; i < offsets[v + 1]; ++i) {
+            int u = targets[i];
+            if (core[u] >= min_core && position[u] > position[v]) search.swap_to(u, end_p++);
+        }
+        search.R.assign(1, v);
+        expand(0, end_x, end_p, search);
+    }
+
+    // The number of vertices of the range [begin, end) adjacent to u, by whichever of the range and
+    // u's neighborhood is shorter.
+    int neighbors_in_range(int u, int begin, int end, const Search& search) const {
+        int count = 0;
+        if (degree(u) <= end - begin) {
+            for (int i = offsets[u]; i < offsets[u + 1]; ++i) {
+                int j = search.index[targets[i]];
+                count += j >= begin && j < end;
+            }
+        } else {
+            for (int i = begin; i < end; ++i) count += adjacent(u, search.vertices[i]);
+        }
+        return count;
+    }
+
+    void expand(int begin_x, int begin_p, int end_p, Search& search) {
+        const CliqueSearchOptions& options = search.options;
+        std::vector<int>& R = search.R;
+        std::vector<int>& vertices = search.vertices;
+        search.stats.nodes++;
+        search.stats.max_depth = std::max(search.stats.max_depth, static_cast<int>(R.size()));
+        if (search.memory->exceeded()) {
+            return;
+        }
+        if (static_cast<int>(R.size()) + end_p - begin_p < options.min_size) {
+            search.stats.pruned++;
+            return;
+        }
+        if (begin_p == end_p) {
+            if (begin_x == begin_p) report(search);
+            return;
+        }
+        if (static_cast<int>(R.size()) >= options.max_size) {
+            report(search);
+            return;
+        }
+        // Tomita pivot: the vertex of P or X with the most neighbors in P.
+        int pivot = -1, best = -1;
+        for (int i = begin_x; i < end_p && best < end_p - begin_p; ++i) {
+            int count = neighbors_in_range(vertices[i], begin_p, end_p, search);
+            if (count > best) {
+                pivot = vertices[i];
+                best = count;
+            }
+        }
+        // Partition P so that the pivot's neighbors come first; the rest are the branches.
+        int split = begin_p;
+        for (int i = begin_p; i < end_p; ++i) {
+            if (adjacent(pivot, vertices[i])) search.swap_to(vertices[i], split++);
+        }
+        size_t base = search.branches.size();
+        search.branches.insert(search.branches.end(), vertices.begin() + split, vertices.begin() + end_p);
+        size_t top = search.branches.size(), t = base;
+        ScopedMemoryCharge branches_charge(search.memory, (top - base) * sizeof(int));
+        for (; t < top && branches_charge.ok() && !search.memory->exceeded(); ++t) {
+            // P only shrinks from here on, so no later branch can reach min_size either.
+            if (static_cast<int>(R.size()) + end_p - begin_p < options.min_size) {
+                break;
+            }
+            int v = search.branches[t];
+            // The child's P is P ∩ N(v), moved to the front of P; its X is X ∩ N(v), moved to the back of X.
+            int child_end_p = begin_p, child_begin_x = begin_p;
+            if (degree(v) <= end_p - begin_x) {
+                for (int i = offsets[v]; i < offsets[v + 1]; ++i) {
+                    int u = targets[i];
+                    int j = search.index[u];
+                    if (j >= begin_p && j < end_p) {
+                        search.swap_to(u, child_end_p++);
+                    } else if (j >= begin_x && j < begin_p) {
+                        search.swap_to(u, --child_begin_x);
+                    }
+                }
+            } else {
+                for (int i = begin_p; i < end_p; ++i) {
+                    if (adjacent(v, vertices[i])) search.swap_to(vertices[i], child_end_p++);
+                }
+                for (int i = begin_p - 1; i >= begin_x; --i) {
+                    if (adjacent(v, vertices[i])) search.swap_to(vertices[i], --child_begin_x);
+                }
+            }
+            R.push_back(v);
+            expand(child_begin_x, begin_p, child_end_p, search);
+            R.pop_back();
+            // Move v from P to X: swap it to the front of P and shrink P past it.
+            search.swap_to(v, begin_p++);
+        }
+        // The children partitioned X together with the vertices moved into it, which may have mixed
+        // the two across the parent's boundary; moving those vertices back restores the parent's X and P.
+        while (t > base) {
+            search.swap_to(search.branches[--t], --begin_p);
+        }
+        search.branches.resize(base);
+    }
+
+    void report(Search& search) {
+        search.emit(std::set<int>(search.R.begin(), search.R.end()));
+        search.stats.cliques++;
+    }
+};
+
+#endif  // PARTITION_ENGINE_H
@@ -0,0 +1,474 @@
+#ifndef ROARING_BITMAP_H
+#define ROARING_BITMAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Compressed bitmap of non-negative ints in the style of Roaring bitmaps.
+ * @brief Values are split by their high 16 bits into chunks of 65536. Each non-empty chunk is stored
+ *        in the smallest of three containers: a sorted array of the low 16 bits (at most 4096
+ *        values), a 65536-bit bitmap, or a list of runs. Intersections and cardinalities work
+ *        container by container, so sparse sets stay small and dense ones stay word-parallel.
+ *        Usable as the VertexSet of SparseCliqueEngine.
+ */
+class RoaringBitmap {
+public:
+    RoaringBitmap() = default;
+
+    /**
+     * @brief Builds a bitmap from values in increasing order, without duplicates.
+     * @note Time Complexity: O(k) for k values.
+     */
+    static RoaringBitmap from_sorted(const std::vector<int>& values) {
+        RoaringBitmap result;
+        size_t i = 0;
+        while (i < values.size()) {
+            uint16_t key = high(values[i]);
+            Container c;
+            while (i < values.size() && high(values[i]) == key) {
+                c.array.push_back(low(values[i++]));
+            }
+            c.cardinality = static_cast<uint32_t>(c.array.size());
+            if (c.cardinality > array_limit) {
+                c.to_bitmap();
+            }
+            result.keys.push_back(key);
+            result.containers.push_back(std::move(c));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns the number of values in the bitmap.
+     */
+    size_t size() const {
+        size_t total = 0;
+        for (const Container& c : containers) total += c.cardinality;
+        return total;
+    }
+
+    bool empty() const {
+        return containers.empty();
+    }
+
+    bool contains(int v) const {
+        int i = find_key(high(v));
+        return i >= 0 && containers[i].contains(low(v));
+    }
+
+    void add(int v) {
+        uint16_t key = high(v);
+        auto it = std::lower_bound(keys.begin(), keys.end(), key);
+        size_t i = it - keys.begin();
+        if (it == keys.end() || *it != key) {
+            keys.insert(it, key);
+            containers.insert(containers.begin() + i, Container());
+        }
+        containers[i].add(low(v));
+    }
+
+    void remove(int v) {
+        int i = find_key(high(v));
+        if (i < 0) return;
+        containers[i].remove(low(v));
+        if (containers[i].cardinality == 0) {
+            keys.erase(keys.begin() + i);
+            containers.erase(containers.begin() + i);
+        }
+    }
+
+    /**
+     * @brief Returns the values present in both bitmaps.
+     */
+    RoaringBitmap intersect(const RoaringBitmap& other) const {
+        RoaringBitmap result;
+        size_t i = 0, j = 0;
+        while (i < keys.size() && j < other.keys.size()) {
+            if (keys[i] < other.keys[j]) {
+                ++i;
+            } else if (keys[i] > other.keys[j]) {
+                ++j;
+            } else {
+                Container c = Container::intersect(containers[i], other.containers[j]);
+                if (c.cardinality > 0) {
+                    result.keys.push_back(keys[i]);
+                    result.containers.push_back(std::move(c));
+                }
+                ++i;
+                ++j;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns the values of this bitmap that are not in 'other'.
+     */
+    RoaringBitmap difference(const RoaringBitmap& other) const {
+        RoaringBitmap result;
+        size_t j = 0;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            while (j < other.keys.size() && other.keys[j] < keys[i]) ++j;
+            Container c = j < other.keys.size() && other.keys[j] == keys[i]
+                              ? Container::difference(containers[i], other.containers[j])
+                              : containers[i];
+            if (c.cardinality > 0) {
+                result.keys.push_back(keys[i]);
+                result.containers.push_back(std::move(c));
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Returns the size of the intersection without building it.
+     */
+    size_t intersection_size(const RoaringBitmap& other) const {
+        size_t total = 0;
+        size_t i = 0, j = 0;
+        while (i < keys.size() && j < other.keys.size()) {
+            if (keys[i] < other.keys[j]) {
+                ++i;
+            } else if (keys[i] > other.keys[j]) {
+                ++j;
+            } else {
+                total += Container::intersection_size(containers[i], other.containers[j]);
+                ++i;
+                ++j;
+            }
+        }
+        return total;
+    }
+
+    /**
+     * @brief Computes new_P = P ∩ N and new_X = X ∩ N.
+     */
+    static void intersect_pair(const RoaringBitmap& P, const RoaringBitmap& X, const RoaringBitmap& N,
+                               RoaringBitmap& new_P, RoaringBitmap& new_X) {
+        new_P = P.intersect(N);
+        new_X = X.intersect(N);
+    }
+
+    /**
+     * @brief Calls f(v) for every value, in increasing order.
+     */
+    template <typename F>
+    void for_each(F&& f) const {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            int base = static_cast<int>(keys[i]) << 16;
+            containers[i].for_each([&](uint16_t value) { f(base | value); });
+        }
+    }
+
+    /**
+     * @brief Converts containers to runs wherever that is smaller, e.g. for contiguous id ranges.
+     */
+    void run_optimize() {
+        for (Container& c : containers) c.run_optimize();
+    }
+
+    /**
+     * @brief Returns the number of bytes used by the containers.
+     */
+    size_t memory_bytes() const {
+        size_t total = sizeof(*this) + keys.capacity() * sizeof(uint16_t);
+        for (const Container& c : containers) {
+            total += sizeof(Container) + c.array.capacity() * sizeof(uint16_t) + c.bitmap.capacity() * sizeof(uint64_t) +
+                     c.runs.capacity() * sizeof(uint16_t);
+        }
+        return total;
+    }
+
+    bool operator==(const RoaringBitmap& other) const {
+        size_t n = size();
+        return keys == other.keys && other.size() == n && intersection_size(other) == n;
+    }
+
+private:
+    // Array containers hold at most this many values; beyond it a bitmap is smaller.
+    static const uint32_t array_limit = 4096;
+    static const size_t bitmap_words = 1024;
+
+    struct Container {
+        enum class Type { Array, Bitmap, Run };
+        Type type = Type::Array;
+        uint32_t cardinality = 0;
+        // Type::Array: the sorted values.
+        std::vector<uint16_t> array;
+        // Type::Bitmap: 65536 bits.
+        std::vector<uint64_t> bitmap;
+        // Type::Run: (start, length - 1) pairs, sorted and non-adjacent.
+        std::vector<uint16_t> runs;
+
+        bool contains(uint16_t value) const {
+            switch (type) {
+                case Type::Array:
+                    return std::binary_search(array.begin(), array.end(), value);
+                case Type::Bitmap:
+                    return bitmap[value >> 6] >> (value & 63) & 1;
+                case Type::Run:
+                    for (size_t r = 0; r < runs.size(); r += 2) {
+                        if (value < runs[r]) return false;
+                        if (value <= runs[r] + runs[r + 1]) return true;
+                    }
+                    return false;
+            }
+            return false;
+        }
+
+        template <typename F>
+        void for_each(F&& f) const {
+            switch (type) {
+                case Type::Array:
+                    for (uint16_t value : array) f(value);
+                    break;
+                case Type::Bitmap:
+                    for (size_t w = 0; w < bitmap_words; ++w) {
+                        for (uint64_t word = bitmap[w]; word; word &= word - 1) {
+                            f(static_cast<uint16_t>(w * 64 + __builtin_ctzll(word)));
+                        }
+                    }
+                    break;
+                case Type::Run:
+                    for (size_t r = 0; r < runs.size(); r += 2) {
+                        for (uint32_t value = runs[r]; value <= static_cast<uint32_t>(runs[r]) + runs[r + 1]; ++value) {
+                            f(static_cast<uint16_t>(value));
+                        }
+                    }
+                    break;
+            }
+        }
+
+        void add(uint16_t value) {
+            if (type == Type::Run) to_bitmap();
+            if (type == Type::Bitmap) {
+                uint64_t bit = uint64_t(1) << (value & 63);
+                if (!(bitmap[value >> 6] & bit)) {
+                    bitmap[value >> 6] |= bit;
+                    cardinality++;
+                }
+                return;
+            }
+            auto it = std::lower_bound(array.begin(), array.end(), value);
+            if (it != array.end() && *it == value) return;
+            array.insert(it, value);
+            cardinality++;
+            if (cardinality > array_limit) to_bitmap();
+        }
+
+        void remove(uint16_t value) {
+            if (type == Type::Run) to_bitmap();
+            if (type == Type::Bitmap) {
+                uint64_t bit = uint64_t(1) << (value & 63);
+                if (bitmap[value >> 6] & bit) {
+                    bitmap[value >> 6] &= ~bit;
+                    cardinality--;
+                    if (cardinality <= array_limit) to_array();
+                }
+                return;
+            }
+            auto it = std::lower_bound(array.begin(), array.end(), value);
+            if (it != array.end() && *it == value) {
+                array.erase(it);
+                cardinality--;
+            }
+        }
+
+        void to_bitmap() {
+            std::vector<uint64_t> bits(bitmap_words, 0);
+            for_each([&](uint16_t value) { bits[value >> 6] |= uint64_t(1) << (value & 63); });
+            bitmap = std::move(bits);
+            array.clear();
+            array.shrink_to_fit();
+            runs.clear();
+            runs.shrink_to_fit();
+            type = Type::Bitmap;
+        }
+
+        void to_array() {
+            std::vector<uint16_t> values;
+            values.reserve(cardinality);
+            for_each([&](uint16_t value) { values.push_back(value); });
+            array = std::move(values);
+            bitmap.clear();
+            bitmap.shrink_to_fit();
+            runs.clear();
+            runs.shrink_to_fit();
+            type = Type::Array;
+        }
+
+        // Picks the array or bitmap representation by cardinality.
+        void normalize() {
+            if (type == Type::Bitmap && cardinality <= array_limit) {
+                to_array();
+            } else if (type == Type::Array && cardinality > array_limit) {
+                to_bitmap();
+            }
+        }
+
+        void run_optimize() {
+            std::vector<uint16_t> new_runs;
+            for_each([&](uint16_t value) {
+                size_t n = new_runs.size();
+                if (n > 0 && static_cast<uint32_t>(new_runs[n - 2]) + new_runs[n - 1] + 1 == value) {
+                    new_runs[n - 1]++;
+                } else {
+                    new_runs.push_back(value);
+                    new_runs.push_back(0);
+                }
+            });
+            size_t current_bytes = type == Type::Bitmap ? bitmap_words * 8 : type == Type::Array ? array.size() * 2 : runs.size() * 2;
+            if (new_runs.size() * 2 < current_bytes) {
+                runs = std::move(new_runs);
+                array.clear();
+                array.shrink_to_fit();
+                bitmap.clear();
+                bitmap.shrink_to_fit();
+                type = Type::Run;
+            } else if (type == Type::Run) {
+                if (cardinality > array_limit) {
+                    to_bitmap();
+                } else {
+                    to_array();
+                }
+            }
+        }
+
+        static Container from_bitmap(std::vector<uint64_t> bits) {
+            Container c;
+            c.type = Type::Bitmap;
+            for (uint64_t word : bits) c.cardinality += __builtin_popcountll(word);
+            c.bitmap = std::move(bits);
+            c.normalize();
+            return c;
+        }
+
+        // The container as a bitmap, converting if needed.
+        static std::vector<uint64_t> bits_of(const Container& c) {
+            if (c.type == Type::Bitmap) return c.bitmap;
+            std::vector<uint64_t> bits(bitmap_words, 0);
+            if (c.type == Type::Run) {
+                for (size_t r = 0; r < c.runs.size(); r += 2) {
+                    uint32_t first = c.runs[r], last = first + c.runs[r + 1];
+                    for (uint32_t w = first >> 6; w <= last >> 6; ++w) {
+                        uint64_t mask = ~uint64_t(0);
+                        if (w == first >> 6) mask &= ~uint64_t(0) << (first & 63);
+                        if (w == last >> 6 && (last & 63) != 63) mask &= (uint64_t(1) << ((last & 63) + 1)) - 1;
+                        bits[w] |= mask;
+                    }
+                }
+            } else {
+                for (uint16_t value : c.array) bits[value >> 6] |= uint64_t(1) << (value & 63);
+            }
+            return bits;
+        }
+
+        // The values of an array container that 'other' contains (or, if keep is false, does not).
+        static Container filter_array(const Container& a, const Container& other, bool keep) {
+            Container c;
+            if (other.type == Type::Array) {
+                // Merge of two sorted arrays.
+                size_t j = 0;
+                for (uint16_t value : a.array) {
+                    while (j < other.array.size() && other.array[j] < value) ++j;
+                    bool present = j < other.array.size() && other.array[j] == value;
+                    if (present == keep) c.array.push_back(value);
+                }
+            } else if (other.type == Type::Bitmap) {
+                for (uint16_t value : a.array) {
+                    bool present = other.bitmap[value >> 6] >> (value & 63) & 1;
+                    if (present == keep) c.array.push_back(value);
+                }
+            } else {
+                size_t r = 0;
+                for (uint16_t value : a.array) {
+                    while (r < other.runs.size() && static_cast<uint32_t>(other.runs[r]) + other.runs[r + 1] < value) r += 2;
+                    bool present = r < other.runs.size() && other.runs[r] <= value;
+                    if (present == keep) c.array.push_back(value);
+                }
+            }
+            c.cardinality = static_cast<uint32_t>(c.array.size());
+            return c;
+        }
+
+        static Container intersect(const Container& a, const Container& b) {
+            if (a.type == Type::Array) return filter_array(a, b, true);
+            if (b.type == Type::Array) return filter_array(b, a, true);
+            if (a.type == Type::Run && b.type == Type::Run) {
+                Container c;
+                c.type = Type::Run;
+                size_t i = 0, j = 0;
+                while (i < a.runs.size() && j < b.runs.size()) {
+                    uint32_t a_end = static_cast<uint32_t>(a.runs[i]) + a.runs[i + 1];
+                    uint32_t b_end = static_cast<uint32_t>(b.runs[j]) + b.runs[j + 1];
+                    uint32_t start = std::max(a.runs[i], b.runs[j]), end = std::min(a_end, b_end);
+                    if (start <= end) {
+                        c.runs.push_back(static_cast<uint16_t>(start));
+                        c.runs.push_back(static_cast<uint16_t>(end - start));
+                        c.cardinality += end - start + 1;
+                    }
+                    if (a_end < b_end) {
+                        i += 2;
+                    } else {
+                        j += 2;
+                    }
+                }
+                return c;
+            }
+            std::vector<uint64_t> bits = bits_of(a);
+            std::vector<uint64_t> other = bits_of(b);
+            for (size_t w = 0; w < bitmap_words; ++w) bits[w] &= other[w];
+            return from_bitmap(std::move(bits));
+        }
+
+        static Container difference(const Container& a, const Container& b) {
+            if (a.type == Type::Array) return filter_array(a, b, false);
+            std::vector<uint64_t> bits = bits_of(a);
+            if (b.type == Type::Array) {
+                for (uint16_t value : b.array) bits[value >> 6] &= ~(uint64_t(1) << (value & 63));
+            } else {
+                std::vector<uint64_t> other = bits_of(b);
+                for (size_t w = 0; w < bitmap_words; ++w) bits[w] &= ~other[w];
+            }
+            return from_bitmap(std::move(bits));
+        }
+
+        static size_t intersection_size(const Container& a, const Container& b) {
+            if (a.type == Type::Bitmap && b.type == Type::Bitmap) {
+                size_t total = 0;
+                for (size_t w = 0; w < bitmap_words; ++w) total += __builtin_popcountll(a.bitmap[w] & b.bitmap[w]);
+                return total;
+            }
+            if (a.type == Type::Array && b.type == Type::Bitmap) {
+                size_t total = 0;
+                for (uint16_t value : a.array) total += b.bitmap[value >> 6] >> (value & 63) & 1;
+                return total;
+            }
+            if (a.type == Type::Bitmap && b.type == Type::Array) return intersection_size(b, a);
+            return intersect(a, b).cardinality;
+        }
+    };
+
+    // The high 16 bits of every container's values, in increasing order.
+    std::vector<uint16_t> keys;
+    std::vector<Container> containers;
+
+    static uint16_t high(int v) {
+        return static_cast<uint16_t>(static_cast<uint32_t>(v) >> 16);
+    }
+
+    static uint16_t low(int v) {
+        return static_cast<uint16_t>(v & 0xFFFF);
+    }
+
+    int find_key(uint16_t key) const {
+        auto it = std::lower_bound(keys.begin(), keys.end(), key);
+        return it != keys.end() && *it == key ? static_cast<int>(it - keys.begin()) : -1;
+    }
+};
+
+#endif  // ROARING_BITMAP_H
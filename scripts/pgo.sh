@@ -0,0 +1,69 @@
+#!/bin/sh
+# Profile-guided build of the engine executables.
+#
+# 1. Builds instrumented binaries (BK_PGO=GENERATE).
+# 2. Trains them with 'bk_bench --training' on the benchmark families (sparse social,
+#    dense random and Moon-Moser graphs through every pivot policy and ordering), and
+#    trains bk_cli on generated edge-list files through its engines and output modes.
+# 3. Rebuilds the same build tree with the collected profile (BK_PGO=USE).
+# 4. Builds a non-PGO baseline and compares the two benchmark totals.
+#
+# Usage: scripts/pgo.sh [output_dir] [extra cmake arguments...]
+set -eu
+
+src=$(cd "$(dirname "$0")/.." && pwd)
+out=${1:-"$src/build-pgo"}
+[ $# -gt 0 ] && shift
+profiles="$out/profiles"
+jobs=$(nproc 2>/dev/null || echo 2)
+
+echo "== Instrumented build"
+rm -rf "$profiles"
+cmake -S "$src" -B "$out/pgo" -DBK_PGO=GENERATE -DBK_PGO_DIR="$profiles" "$@"
+cmake --build "$out/pgo" -j "$jobs" --target bk_bench bk_cli
+
+echo "== Training run"
+"$out/pgo/bk_bench" --training
+
+# bk_cli reads graph files, so it trains on generated ones: a sparse random graph and the
+# Moon-Moser graph on 30 vertices (the complement of 10 disjoint triangles, 3^10 cliques).
+graphs="$out/training-graphs"
+mkdir -p "$graphs"
+awk 'BEGIN { srand(1); for (i = 0; i < 40000; i++) print int(rand() * 4000), int(rand() * 4000) }' \
+    >"$graphs/sparse.txt"
+awk 'BEGIN { for (u = 0; u < 30; u++) for (v = u + 1; v < 30; v++) if (int(u / 3) != int(v / 3)) print u, v }' \
+    >"$graphs/moon_moser.txt"
+cli="$out/pgo/bk_cli"
+for graph in "$graphs/sparse.txt" "$graphs/moon_moser.txt"; do
+    "$cli" "$graph" --output /dev/null
+    "$cli" "$graph" --pivot maxdegree --ordering core --count
+    "$cli" "$graph" --threads 4 --deterministic --count
+    "$cli" "$graph" --sorted --threads 2 --output /dev/null
+    "$cli" "$graph" --min-size 3 --coloring-depth 2 --count
+    "$cli" "$graph" --edge-support --count
+    "$cli" "$graph" --twins --count
+    "$cli" "$graph" --top-k 10 --output /dev/null
+    for engine in roaring sorted partition; do
+        "$cli" "$graph" --engine "$engine" --count
+    done
+done
+
+if ls "$profiles"/*.profraw >/dev/null 2>&1; then
+    # Clang writes raw profiles that have to be merged first.
+    llvm-profdata merge -output="$profiles/default.profdata" "$profiles"/*.profraw
+fi
+
+echo "== Optimized build"
+cmake -S "$src" -B "$out/pgo" -DBK_PGO=USE -DBK_PGO_DIR="$profiles" "$@"
+cmake --build "$out/pgo" -j "$jobs" --target bk_bench bk_cli
+
+echo "== Baseline build"
+cmake -S "$src" -B "$out/baseline" -DBK_PGO=OFF "$@"
+cmake --build "$out/baseline" -j "$jobs" --target bk_bench
+
+echo "== Comparison (best of 3)"
+baseline=$("$out/baseline/bk_bench" --training --repetitions 3 | sed -n 's/^Total: \(.*\) ms$/\1/p')
+pgo=$("$out/pgo/bk_bench" --training --repetitions 3 | sed -n 's/^Total: \(.*\) ms$/\1/p')
+echo "baseline: $baseline ms"
+echo "pgo:      $pgo ms"
+awk -v b="$baseline" -v p="$pgo" 'BEGIN { printf "speedup:  %.2fx\n", b / p }'
@@ -0,0 +1,114 @@
+#ifndef SORTED_OUTPUT_H
+#define SORTED_OUTPUT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "bron_kerbosch.h"
+#include "clique_store.h"
+
+/**
+ * @brief Streams the maximal cliques of a Graph in canonical order: the order of std::set<int>'s
+ *        operator<, whatever the number of threads.
+ * @brief Every maximal clique is found exactly once in the subproblem of its smallest vertex v,
+ *        which starts from R = {v}, P = the neighbors of v above it and X = those below it. All
+ *        cliques of v's subproblem sort before those of any later vertex, so sorting each
+ *        subproblem's cliques and concatenating the subproblems in order of v gives the canonical
+ *        order without a global sort. Worker threads solve and sort the subproblems, at most
+ *        4 * num_threads of them ahead of the output. Each one collects into a CliqueStore, so a
+ *        subproblem with more cliques than its share of the buffer is merge-sorted from disk
+ *        instead.
+ *
+ *        The bytes buffered in memory by the pending subproblems are charged to the search's
+ *        MemoryBudget until they are written, so a memory limit bounds them along with the
+ *        search's scratch sets.
+ */
+class SortedCliqueOutput {
+public:
+    /**
+     * @brief Streams the maximal cliques of g in canonical order.
+     * @param g The graph.
+     * @param on_clique Called once per reported clique, in canonical order, on the calling thread.
+     *                  An exception it throws stops the search and is rethrown.
+     * @param num_threads The number of worker threads; 1 or less solves the subproblems on the
+     *                    calling thread.
+     * @param options The size bounds, coloring bound depth, vertex ordering and memory budget of the
+     *                search; progress reporting is not supported.
+     * @param stats Receives the instrumentation counters, summed over the subproblems.
+     * @param pivot The pivot policy; every worker gets its own copy.
+     * @param buffer_bytes The memory for cliques awaiting output, shared by the pending subproblems.
+     * @note Cliques truncated at max_size depend on the search order, as in the other searches.
+     */
+    template <typename PivotPolicy = MaxDegreePivot>
+    static void for_each_max_clique(Graph& g, const CliqueCallback& on_clique, int num_threads,
+                                    const CliqueSearchOptions& options, CliqueSearchStats& stats,
+                                    PivotPolicy pivot = PivotPolicy(), size_t buffer_bytes = size_t(256) << 20) {
+        stats = CliqueSearchStats();
+        if (g.num_vertices == 0 || options.max_size < 1 || options.min_size > options.max_size) {
+            return;
+        }
+        num_threads = std::max(1, num_threads);
+        MemoryBudget local_budget;
+        MemoryBudget* memory = options.memory ? options.memory : &local_budget;
+        Graph::SearchTables tables = g.make_search_tables(options);
+        std::vector<int> core;
+        if (options.min_size > 2) {
+            core = g.core_numbers();
+        }
+        auto candidate = [&](int u) { return core.empty() || core[u] >= options.min_size - 1; };
+        const size_t window = 4 * static_cast<size_t>(num_threads);
+        const size_t partition_bytes = std::max<size_t>(buffer_bytes / window, 64 << 10);
+
+        std::vector<CliqueSearchStats> worker_stats(num_threads);
+        std::vector<PivotPolicy> pivots(num_threads, pivot);
+        WorkerOptions worker_options(options, num_threads);
+        // Solves the subproblem of vertex v into a new store, which charges its buffer to the budget
+        // until it is destroyed.
+        auto solve = [&](size_t i, int id) {
+            int v = static_cast<int>(i);
+            auto store = std::make_unique<CliqueStore>(partition_bytes, "", memory);
+            if (!candidate(v) || memory->exceeded()) {
+                return store;
+            }
+            std::set<int> R = {v}, P, X;
+            for (int u : g.get_neighbors(v)) {
+                if (candidate(u)) (u > v ? P : X).insert(u);
+            }
+            CliqueCallback emit = store->collector();
+            Graph::SearchContext ctx{worker_options[id], emit, worker_stats[id], tables, SIZE_MAX, nullptr, memory};
+            ScopedMemoryCharge root_charge(memory, set_memory_bytes(R) + set_memory_bytes(P) + set_memory_bytes(X));
+            if (root_charge.ok()) {
+                g.bron_kerbosch(R, P, X, ctx, pivots[id], nullptr);
+            }
+            return store;
+        };
+        auto output = [&](std::unique_ptr<CliqueStore> store) {
+            store->for_each(
+                [&](const std::vector<int>& clique) { on_clique(std::set<int>(clique.begin(), clique.end())); });
+        };
+        run_in_order(g.num_vertices, num_threads, window, solve, output);
+        for (const auto& ws : worker_stats) {
+            stats.nodes += ws.nodes;
+            stats.cliques += ws.cliques;
+            stats.pruned += ws.pruned;
+            stats.max_depth = std::max(stats.max_depth, ws.max_depth);
+        }
+        record_memory_stats(*memory, stats);
+    }
+};
+
+/**
+ * @brief Streams the maximal cliques of g in canonical order; see SortedCliqueOutput.
+ */
+template <typename PivotPolicy = MaxDegreePivot>
+void for_each_max_clique_sorted(Graph& g, const CliqueCallback& on_clique, int num_threads,
+                                const CliqueSearchOptions& options, CliqueSearchStats& stats,
+                                PivotPolicy pivot = PivotPolicy(), size_t buffer_bytes = size_t(256) << 20) {
+    SortedCliqueOutput::for_each_max_clique(g, on_clique, num_threads, options, stats, pivot, buffer_bytes);
+}
+
+#endif  // SORTED_OUTPUT_H
@@ -0,0 +1,241 @@
+#ifndef SORTED_VERTEX_SET_H
+#define SORTED_VERTEX_SET_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Intersection kernels for strictly increasing int arrays. Each writes the common values, in
+// increasing order, to 'out' (which needs room for min(na, nb) values) and returns their number.
+namespace intersection {
+
+/**
+ * @brief Merge intersection whose loop body has no data-dependent branches.
+ * @note Time Complexity: O(na + nb).
+ */
+inline size_t merge_branchless(const int* a, size_t na, const int* b, size_t nb, int* out) {
+    size_t i = 0, j = 0, k = 0;
+    while (i < na && j < nb) {
+        int x = a[i], y = b[j];
+        out[k] = x;
+        k += x == y;
+        i += x <= y;
+        j += y <= x;
+    }
+    return k;
+}
+
+/**
+ * @brief Galloping intersection: every value of the small array is located in the large one by an
+ *        exponential search from the previous match, then a binary search.
+ * @note Time Complexity: O(na log(nb / na)) for na <= nb.
+ */
+inline size_t gallop(const int* small, size_t na, const int* large, size_t nb, int* out) {
+    size_t k = 0, lo = 0;
+    for (size_t i = 0; i < na && lo < nb; ++i) {
+        int x = small[i];
+        size_t step = 1, hi = lo;
+        while (hi < nb && large[hi] < x) {
+            lo = hi + 1;
+            hi += step;
+            step *= 2;
+        }
+        hi = std::min(hi, nb);
+        lo = std::lower_bound(large + lo, large + hi, x) - large;
+        if (lo < nb && large[lo] == x) {
+            out[k++] = x;
+            lo++;
+        }
+    }
+    return k;
+}
+
+/**
+ * @brief SIMD intersection: blocks of 4 values of each array are compared all-against-all with
+ *        four rotated 128-bit compares, and the block with the smaller maximum is advanced.
+ *        Falls back to merge_branchless where SSE2 is unavailable.
+ * @note Time Complexity: O(na + nb), in 4-wide steps.
+ */
+inline size_t simd_4x4(const int* a, size_t na, const int* b, size_t nb, int* out) {
+    size_t i = 0, j = 0, k = 0;
+#if defined(__SSE2__)
+    while (i + 4 <= na && j + 4 <= nb) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        __m128i match = _mm_cmpeq_epi32(va, vb);
+        match = _mm_or_si128(match, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1))));
+        match = _mm_or_si128(match, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))));
+        match = _mm_or_si128(match, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3))));
+        for (int mask = _mm_movemask_ps(_mm_castsi128_ps(match)); mask; mask &= mask - 1) {
+            out[k++] = a[i + __builtin_ctz(mask)];
+        }
+        int a_max = a[i + 3], b_max = b[j + 3];
+        i += a_max <= b_max ? 4 : 0;
+        j += b_max <= a_max ? 4 : 0;
+    }
+#endif
+    return k + merge_branchless(a + i, na - i, b + j, nb - j, out + k);
+}
+
+/**
+ * @brief Picks a kernel by the sizes of the inputs: galloping when one array is at least 32 times
+ *        longer than the other, SIMD blocks when both are long, the branch-free merge otherwise.
+ */
+inline size_t adaptive(const int* a, size_t na, const int* b, size_t nb, int* out) {
+    if (na == 0 || nb == 0) return 0;
+    if (na > nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (nb / na >= 32) return gallop(a, na, b, nb, out);
+    if (na >= 16) return simd_4x4(a, na, b, nb, out);
+    return merge_branchless(a, na, b, nb, out);
+}
+
+/**
+ * @brief Intersects one array with two disjoint arrays in a single pass: writes P ∩ N to out_p and
+ *        X ∩ N to out_x, and returns their sizes. When N is much longer than P and X together,
+ *        the two intersections gallop through N separately instead.
+ */
+inline std::pair<size_t, size_t> split(const int* p, size_t np, const int* x, size_t nx, const int* n, size_t nn,
+                                       int* out_p, int* out_x) {
+    if (nn / std::max<size_t>(np + nx, 1) >= 32) {
+        return {adaptive(p, np, n, nn, out_p), adaptive(x, nx, n, nn, out_x)};
+    }
+    size_t i = 0, j = 0, kp = 0, kx = 0;
+    for (size_t t = 0; t < nn && (i < np || j < nx); ++t) {
+        int v = n[t];
+        while (i < np && p[i] < v) ++i;
+        while (j < nx && x[j] < v) ++j;
+        out_p[kp] = v;
+        out_x[kx] = v;
+        kp += i < np && p[i] == v;
+        kx += j < nx && x[j] == v;
+    }
+    return {kp, kx};
+}
+
+/**
+ * @brief Counts the common values without writing them.
+ */
+inline size_t count(const int* a, size_t na, const int* b, size_t nb) {
+    if (na > nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    size_t k = 0;
+    if (na > 0 && nb / na >= 32) {
+        const int* lo = b;
+        for (size_t i = 0; i < na; ++i) {
+            lo = std::lower_bound(lo, b + nb, a[i]);
+            if (lo == b + nb) break;
+            k += *lo == a[i];
+        }
+        return k;
+    }
+    size_t i = 0, j = 0;
+    while (i < na && j < nb) {
+        int x = a[i], y = b[j];
+        k += x == y;
+        i += x <= y;
+        j += y <= x;
+    }
+    return k;
+}
+
+}  // namespace intersection
+
+/**
+ * @brief Vertex set stored as a sorted array, for SparseCliqueEngine on sparse graphs. Intersections
+ *        use the adaptive kernels of namespace intersection, and new P and X are split from a
+ *        neighborhood in one fused pass.
+ */
+class SortedVertexSet {
+public:
+    SortedVertexSet() = default;
+
+    static SortedVertexSet from_sorted(const std::vector<int>& values) {
+        SortedVertexSet result;
+        result.values = values;
+        return result;
+    }
+
+    size_t size() const {
+        return values.size();
+    }
+
+    bool empty() const {
+        return values.empty();
+    }
+
+    bool contains(int v) const {
+        return std::binary_search(values.begin(), values.end(), v);
+    }
+
+    void add(int v) {
+        auto it = std::lower_bound(values.begin(), values.end(), v);
+        if (it == values.end() || *it != v) values.insert(it, v);
+    }
+
+    void remove(int v) {
+        auto it = std::lower_bound(values.begin(), values.end(), v);
+        if (it != values.end() && *it == v) values.erase(it);
+    }
+
+    SortedVertexSet intersect(const SortedVertexSet& other) const {
+        SortedVertexSet result;
+        result.values.resize(std::min(size(), other.size()));
+        result.values.resize(intersection::adaptive(values.data(), size(), other.values.data(), other.size(),
+                                                    result.values.data()));
+        return result;
+    }
+
+    SortedVertexSet difference(const SortedVertexSet& other) const {
+        SortedVertexSet result;
+        result.values.reserve(size());
+        std::set_difference(values.begin(), values.end(), other.values.begin(), other.values.end(),
+                            std::back_inserter(result.values));
+        return result;
+    }
+
+    size_t intersection_size(const SortedVertexSet& other) const {
+        return intersection::count(values.data(), size(), other.values.data(), other.size());
+    }
+
+    /**
+     * @brief Computes new_P = P ∩ N and new_X = X ∩ N with the fused kernel.
+     */
+    static void intersect_pair(const SortedVertexSet& P, const SortedVertexSet& X, const SortedVertexSet& N,
+                               SortedVertexSet& new_P, SortedVertexSet& new_X) {
+        // The fused loop writes one value past the last match before testing it.
+        new_P.values.resize(P.size() + 1);
+        new_X.values.resize(X.size() + 1);
+        auto sizes = intersection::split(P.values.data(), P.size(), X.values.data(), X.size(), N.values.data(),
+                                         N.size(), new_P.values.data(), new_X.values.data());
+        new_P.values.resize(sizes.first);
+        new_X.values.resize(sizes.second);
+    }
+
+    template <typename F>
+    void for_each(F&& f) const {
+        for (int v : values) f(v);
+    }
+
+    size_t memory_bytes() const {
+        return sizeof(*this) + values.capacity() * sizeof(int);
+    }
+
+    bool operator==(const SortedVertexSet& other) const {
+        return values == other.values;
+    }
+
+private:
+    std::vector<int> values;
+};
+
+#endif  // SORTED_VERTEX_SET_H
@@ -0,0 +1,468 @@
+#ifndef SPARSE_ENGINE_H
+#define SPARSE_ENGINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bron_kerbosch.h"
+
+/**
+ * @brief Neighborhoods of a graph as one sorted CSR array: the neighbors of v are
+ *        targets[offsets[v]] .. targets[offsets[v + 1] - 1], in increasing order. The sparse
+ *        engines, EdgeSupport and LocalSubgraphExtractor all build their adjacency from it.
+ */
+struct CsrAdjacency {
+    int num_vertices = 0;
+    std::vector<int> offsets;
+    std::vector<int> targets;
+
+    /**
+     * @brief Builds the adjacency from an edge list. Self-loops and parallel edges are ignored.
+     * @param n The number of vertices.
+     * @param edges The edges, as pairs of vertex ids in [0, n).
+     * @note Time Complexity: O(n + m log m) for m edges.
+     */
+    CsrAdjacency(int n, const std::vector<std::pair<int, int>>& edges) : num_vertices(n), offsets(n + 1, 0) {
+        for (const auto& e : edges) {
+            if (e.first != e.second) {
+                offsets[e.first + 1]++;
+                offsets[e.second + 1]++;
+            }
+        }
+        for (int v = 0; v < n; ++v) offsets[v + 1] += offsets[v];
+        targets.resize(offsets[n]);
+        std::vector<int> next(offsets.begin(), offsets.end() - 1);
+        for (const auto& e : edges) {
+            if (e.first != e.second) {
+                targets[next[e.first]++] = e.second;
+                targets[next[e.second]++] = e.first;
+            }
+        }
+        // Sort every neighborhood and drop its duplicates, compacting the array as it goes.
+        int size = 0;
+        for (int v = 0; v < n; ++v) {
+            int begin = offsets[v], end = offsets[v + 1];
+            std::sort(targets.begin() + begin, targets.begin() + end);
+            offsets[v] = size;
+            for (int i = begin; i < end; ++i) {
+                if (i == begin || targets[i] != targets[i - 1]) targets[size++] = targets[i];
+            }
+        }
+        offsets[n] = size;
+        targets.resize(size);
+    }
+
+    /**
+     * @brief Builds the adjacency of a Graph.
+     * @note Time Complexity: O(n^2 / 64 + m).
+     */
+    explicit CsrAdjacency(const Graph& g) : num_vertices(g.num_vertices) {
+        offsets.assign(1, 0);
+        offsets.reserve(num_vertices + 1);
+        for (int v = 0; v < num_vertices; ++v) {
+            const std::vector<uint64_t>& row = g.adj_bits[v];
+            for (size_t w = 0; w < row.size(); ++w) {
+                for (uint64_t word = row[w]; word; word &= word - 1) {
+                    targets.push_back(static_cast<int>(w * 64 + __builtin_ctzll(word)));
+                }
+            }
+            offsets.push_back(static_cast<int>(targets.size()));
+        }
+    }
+
+    int degree(int v) const {
+        return offsets[v + 1] - offsets[v];
+    }
+
+    const int* neighbors(int v) const {
+        return targets.data() + offsets[v];
+    }
+};
+
+/**
+ * @brief Orders the vertices by repeatedly removing one of minimum remaining degree (the
+ *        Matula-Beck bucket algorithm).
+ * @param adjacency The adjacency of the graph.
+ * @param order Receives the vertices in degeneracy order.
+ * @param core Receives the core number of every vertex.
+ * @note Time Complexity: O(n + m).
+ */
+inline void degeneracy_ordering(const CsrAdjacency& adjacency, std::vector<int>& order, std::vector<int>& core) {
+    int n = adjacency.num_vertices;
+    std::vector<int> degree(n);
+    int max_degree = 0;
+    for (int v = 0; v < n; ++v) {
+        degree[v] = adjacency.degree(v);
+        max_degree = std::max(max_degree, degree[v]);
+    }
+    // Vertices sorted by degree, with the start of every degree's bucket.
+    std::vector<int> bucket_start(max_degree + 2, 0);
+    for (int v = 0; v < n; ++v) bucket_start[degree[v] + 1]++;
+    for (int d = 0; d <= max_degree; ++d) bucket_start[d + 1] += bucket_start[d];
+    std::vector<int> sorted(n);
+    std::vector<int> position(n);
+    {
+        std::vector<int> next = bucket_start;
+        for (int v = 0; v < n; ++v) {
+            position[v] = next[degree[v]]++;
+            sorted[position[v]] = v;
+        }
+    }
+    core.assign(n, 0);
+    for (int i = 0; i < n; ++i) {
+        int v = sorted[i];
+        core[v] = degree[v];
+        for (int j = adjacency.offsets[v]; j < adjacency.offsets[v + 1]; ++j) {
+            int u = adjacency.targets[j];
+            if (degree[u] > degree[v]) {
+                // Move u to the front of its bucket, then shrink the bucket past it.
+                int du = degree[u];
+                int front = std::max(bucket_start[du], i + 1);
+                int w = sorted[front];
+                std::swap(sorted[front], sorted[position[u]]);
+                std::swap(position[w], position[u]);
+                bucket_start[du] = front + 1;
+                degree[u]--;
+            }
+        }
+    }
+    order = std::move(sorted);
+}
+
+/**
+ * @brief Runs the outer loop of a degeneracy-ordered search on worker threads.
+ * @param num_roots The number of top-level subproblems; they are handed out one at a time.
+ * @param on_clique The callback of the search. With several threads, the cliques of every worker
+ *                  are batched and the calls serialized by a lock.
+ * @param stats Receives the counters of the workers, summed.
+ * @param memory The budget of the search; no more roots are handed out once it is exceeded.
+ * @param num_threads The number of worker threads.
+ * @param ordered Whether the cliques are passed on in root order, as with one thread. Every root then
+ *                collects its cliques into a segment, charged to the budget, and the segments are
+ *                passed on from the calling thread through run_in_order.
+ * @param make_worker Called once per worker with its clique callback and counters; returns a
+ *                    callable that solves the subproblem of a given root index.
+ * @note An exception of on_clique or a worker stops all workers and is rethrown on the calling thread.
+ */
+template <typename MakeWorker>
+void run_root_workers(size_t num_roots, const CliqueCallback& on_clique, CliqueSearchStats& stats,
+                      MemoryBudget& memory, int num_threads, bool ordered, MakeWorker make_worker) {
+    num_threads = std::max(1, num_threads);
+    if (ordered && num_threads > 1) {
+        // Every worker collects into its own segment, which is handed over whole once a root is solved.
+        // A segment releases the charges of whatever cliques it still holds when it is destroyed, so
+        // nothing stays charged if the output stops early.
+        std::vector<CliqueSegment> segments;
+        std::vector<CliqueCallback> collectors;
+        for (int id = 0; id < num_threads; ++id) {
+            segments.emplace_back(&memory);
+        }
+        for (int id = 0; id < num_threads; ++id) {
+            collectors.push_back([&segment = segments[id]](const std::set<int>& clique) { segment.add(clique); });
+        }
+        std::vector<decltype(make_worker(collectors[0], stats))> solvers;
+        solvers.reserve(num_threads);
+        std::vector<CliqueSearchStats> worker_stats(num_threads);
+        for (int id = 0; id < num_threads; ++id) {
+            solvers.push_back(make_worker(collectors[id], worker_stats[id]));
+        }
+        auto solve = [&](size_t i, int id) {
+            CliqueSegment segment(&memory);
+            if (!memory.exceeded()) {
+                solvers[id](i);
+                segment = std::move(segments[id]);
+            }
+            return segment;
+        };
+        auto output = [&](CliqueSegment segment) { segment.flush(on_clique); };
+        run_in_order(num_roots, num_threads, 4 * static_cast<size_t>(num_threads), solve, output);
+        for (const auto& ws : worker_stats) {
+            stats.nodes += ws.nodes;
+            stats.cliques += ws.cliques;
+            stats.pruned += ws.pruned;
+            stats.max_depth = std::max(stats.max_depth, ws.max_depth);
+        }
+        return;
+    }
+    std::mutex output_mutex;
+    std::atomic<size_t> next_root{0};
+    std::vector<CliqueSearchStats> worker_stats(num_threads);
+    // The first exception of any worker, e.g. from on_clique; the others then stop taking roots.
+    std::exception_ptr error;
+    std::atomic<bool> failed{false};
+    auto worker = [&](int id) {
+        std::vector<std::set<int>> batch;
+        auto flush = [&] {
+            if (batch.empty()) return;
+            std::lock_guard<std::mutex> lock(output_mutex);
+            for (const auto& clique : batch) {
+                on_clique(clique);
+            }
+            batch.clear();
+        };
+        CliqueCallback buffer = [&](const std::set<int>& clique) {
+            if (num_threads == 1) {
+                on_clique(clique);
+                return;
+            }
+            batch.push_back(clique);
+            if (batch.size() >= 256) flush();
+        };
+        auto solve_root = make_worker(buffer, worker_stats[id]);
+        for (size_t i; !memory.exceeded() && !failed && (i = next_root.fetch_add(1)) < num_roots;) {
+            solve_root(i);
+        }
+        flush();
+    };
+    if (num_threads == 1) {
+        worker(0);
+    } else {
+        auto guarded = [&](int id) {
+            try {
+                worker(id);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(output_mutex);
+                if (!error) error = std::current_exception();
+                failed = true;
+            }
+        };
+        std::vector<std::thread> threads;
+        for (int id = 0; id < num_threads; ++id) {
+            threads.emplace_back(guarded, id);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    for (const auto& ws : worker_stats) {
+        stats.nodes += ws.nodes;
+        stats.cliques += ws.cliques;
+        stats.pruned += ws.pruned;
+        stats.max_depth = std::max(stats.max_depth, ws.max_depth);
+    }
+}
+
+/**
+ * @brief Bron-Kerbosch engine for large sparse graphs, parameterized by its vertex set storage.
+ * @brief Unlike Graph, it never allocates anything quadratic in the number of vertices: neighborhoods
+ *        and the P and X sets of every subproblem are VertexSets. The outer loop visits the
+ *        vertices in degeneracy order (Eppstein, Loffler and Strash), so every top-level P holds
+ *        at most degeneracy-many vertices, and below it the search uses Tomita pivoting.
+ *
+ *        A VertexSet provides from_sorted(std::vector<int>), size(), empty(), add(v), remove(v),
+ *        intersect(other), difference(other), intersection_size(other), a static
+ *        intersect_pair(P, X, N, new_P, new_X), for_each(f) in increasing order and memory_bytes().
+ *        RoaringBitmap and SortedVertexSet are such storage policies.
+ */
+template <typename VertexSet>
+class SparseCliqueEngine {
+public:
+    int num_vertices;
+
+    /**
+     * @brief Builds the engine from an edge list. Self-loops and parallel edges are ignored.
+     * @param n The number of vertices.
+     * @param edges The edges, as pairs of vertex ids in [0, n).
+     * @note Time Complexity: O(n + m log m) for m edges.
+     */
+    SparseCliqueEngine(int n, const std::vector<std::pair<int, int>>& edges) : num_vertices(n) {
+        build(CsrAdjacency(n, edges));
+    }
+
+    /**
+     * @brief Builds the engine from the adjacency of a Graph.
+     */
+    explicit SparseCliqueEngine(const Graph& g) : num_vertices(g.num_vertices) {
+        build(CsrAdjacency(g));
+    }
+
+    /**
+     * @brief Returns the neighborhood of vertex v.
+     */
+    const VertexSet& neighbors(int v) const {
+        return adjacency[v];
+    }
+
+    /**
+     * @brief Returns the number of neighbors of vertex v.
+     */
+    int degree(int v) const {
+        return static_cast<int>(adjacency[v].size());
+    }
+
+    /**
+     * @brief Returns the degeneracy of the graph: the largest core number of any vertex.
+     */
+    int degeneracy() const {
+        return core.empty() ? 0 : *std::max_element(core.begin(), core.end());
+    }
+
+    /**
+     * @brief Returns the number of bytes used by the neighborhoods.
+     */
+    size_t memory_bytes() const {
+        size_t total = 0;
+        for (const VertexSet& set : adjacency) total += set.memory_bytes();
+        return total;
+    }
+
+    /**
+     * @brief Streams the maximal cliques to a callback.
+     * @param on_clique Called once per reported clique. With several threads the calls are
+     *                  serialized by an internal lock but come in no particular order; with
+     *                  options.deterministic they come in the order of the one-thread search.
+     * @param options The size bounds, memory budget and output order of the search, with the
+     *                semantics of Graph::find_max_cliques; the coloring bound, vertex ordering and
+     *                progress reporting are not supported.
+     * @param stats Receives the instrumentation counters, summed over the workers.
+     * @param num_threads The number of worker threads; the vertices of the outer loop are handed
+     *                    out to them one at a time.
+     */
+    void for_each_max_clique(const CliqueCallback& on_clique, const CliqueSearchOptions& options,
+                             CliqueSearchStats& stats, int num_threads = 1) {
+        stats = CliqueSearchStats();
+        if (num_vertices == 0 || options.max_size < 1 || options.min_size > options.max_size) {
+            return;
+        }
+        MemoryBudget local_budget;
+        MemoryBudget* memory = options.memory ? options.memory : &local_budget;
+        run_root_workers(order.size(), on_clique, stats, *memory, num_threads, options.deterministic,
+                         [&](const CliqueCallback& emit, CliqueSearchStats& worker_stats) {
+                             return [this, search = Search{options, emit, worker_stats, memory, {}}](size_t i) mutable {
+                                 expand_root(order[i], search);
+                             };
+                         });
+        record_memory_stats(*memory, stats);
+    }
+
+    /**
+     * @brief Finds all maximal cliques.
+     * @return A vector of sets, where each set represents a maximal clique.
+     */
+    std::vector<std::set<int>> find_max_cliques() {
+        std::vector<std::set<int>> cliques;
+        CliqueSearchStats stats;
+        for_each_max_clique([&](const std::set<int>& clique) { cliques.push_back(clique); }, CliqueSearchOptions(),
+                            stats);
+        return cliques;
+    }
+
+private:
+    std::vector<VertexSet> adjacency;
+    // Vertices in degeneracy order, and the index of every vertex in it.
+    std::vector<int> order;
+    std::vector<int> position;
+    std::vector<int> core;
+
+    struct Search {
+        const CliqueSearchOptions& options;
+        const CliqueCallback& emit;
+        CliqueSearchStats& stats;
+        MemoryBudget* memory;
+        std::vector<int> R;
+    };
+
+    void build(const CsrAdjacency& csr) {
+        degeneracy_ordering(csr, order, core);
+        position.assign(num_vertices, 0);
+        for (int i = 0; i < num_vertices; ++i) position[order[i]] = i;
+        adjacency.reserve(num_vertices);
+        for (int v = 0; v < num_vertices; ++v) {
+            adjacency.push_back(VertexSet::from_sorted(std::vector<int>(csr.neighbors(v), csr.neighbors(v) + csr.degree(v))));
+        }
+    }
+
+    // The subproblem of vertex v: its later neighbors are candidates, its earlier ones excluded.
+    void expand_root(int v, Search& search) {
+        const CliqueSearchOptions& options = search.options;
+        int min_core = options.min_size - 1;
+        if (core[v] < min_core) {
+            search.stats.pruned++;
+            return;
+        }
+        std::vector<int> later, earlier;
+        adjacency[v].for_each([&](int u) {
+            if (core[u] < min_core) return;
+            (position[u] > position[v] ? later : earlier).push_back(u);
+        });
+        VertexSet P = VertexSet::from_sorted(later);
+        VertexSet X = VertexSet::from_sorted(earlier);
+        ScopedMemoryCharge root_charge(search.memory, (later.capacity() + earlier.capacity()) * sizeof(int) +
+                                                          P.memory_bytes() + X.memory_bytes());
+        if (!root_charge.ok()) return;
+        search.R.assign(1, v);
+        expand(P, X, search);
+    }
+
+    void expand(VertexSet& P, VertexSet& X, Search& search) {
+        const CliqueSearchOptions& options = search.options;
+        std::vector<int>& R = search.R;
+        search.stats.nodes++;
+        search.stats.max_depth = std::max(search.stats.max_depth, static_cast<int>(R.size()));
+        if (search.memory->exceeded()) {
+            return;
+        }
+        if (static_cast<int>(R.size() + P.size()) < options.min_size) {
+            search.stats.pruned++;
+            return;
+        }
+        if (P.empty()) {
+            if (X.empty()) report(search);
+            return;
+        }
+        if (static_cast<int>(R.size()) >= options.max_size) {
+            report(search);
+            return;
+        }
+        // Tomita pivot: the vertex of P or X with the most neighbors in P.
+        int pivot = -1;
+        size_t best = 0;
+        auto consider = [&](int u) {
+            size_t k = P.intersection_size(adjacency[u]);
+            if (pivot < 0 || k > best) {
+                pivot = u;
+                best = k;
+            }
+        };
+        P.for_each(consider);
+        X.for_each(consider);
+        std::vector<int> branches;
+        P.difference(adjacency[pivot]).for_each([&](int v) { branches.push_back(v); });
+        ScopedMemoryCharge branches_charge(search.memory, branches.capacity() * sizeof(int));
+        for (int v : branches) {
+            // P only shrinks from here on, so no later branch can reach min_size either.
+            if (static_cast<int>(R.size() + P.size()) < options.min_size) {
+                break;
+            }
+            VertexSet new_P, new_X;
+            VertexSet::intersect_pair(P, X, adjacency[v], new_P, new_X);
+            ScopedMemoryCharge child_charge(search.memory, new_P.memory_bytes() + new_X.memory_bytes());
+            if (!child_charge.ok()) {
+                break;
+            }
+            R.push_back(v);
+            expand(new_P, new_X, search);
+            R.pop_back();
+            P.remove(v);
+            X.add(v);
+        }
+    }
+
+    void report(Search& search) {
+        search.emit(std::set<int>(search.R.begin(), search.R.end()));
+        search.stats.cliques++;
+    }
+};
+
+#endif  // SPARSE_ENGINE_H
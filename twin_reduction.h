@@ -0,0 +1,472 @@
+#ifndef TWIN_REDUCTION_H
+#define TWIN_REDUCTION_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bron_kerbosch.h"
+
+// A vertex of the reduced graph: an original vertex, or a class of twins merged into one vertex.
+struct TwinNode {
+    enum class Kind {
+        Vertex,  // The original vertex 'vertex'.
+        All,     // True twins (equal closed neighborhoods): a maximal clique contains all children or none.
+        Any,     // False twins (equal open neighborhoods): a maximal clique contains at most one child,
+                 // and any one can be swapped for another.
+    };
+    Kind kind;
+    int vertex;
+    std::vector<int> children;
+};
+
+/**
+ * @brief A family of maximal cliques that differ only by swapping twins, stored without expanding them.
+ * @brief The family is a product of factors: vertices that are in every clique of the family, and
+ *        choices of one alternative from a class of false twins, where an alternative can itself be a
+ *        product. K(3,3) is the single family {0,1,2} x {3,4,5} of 9 edges.
+ */
+class CliqueFamily {
+public:
+    // Input iterator expanding the cliques of a family one at a time, in odometer order.
+    class iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::set<int>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::set<int>*;
+        using reference = const std::set<int>&;
+
+        iterator() = default;
+
+        reference operator*() const {
+            return current;
+        }
+
+        pointer operator->() const {
+            return &current;
+        }
+
+        iterator& operator++() {
+            advance();
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return family == other.family && choice == other.choice;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class CliqueFamily;
+        // Null for the end iterator.
+        const CliqueFamily* family = nullptr;
+        // The alternative chosen by every Any node; nodes outside the current choice stay at 0.
+        std::vector<int> choice;
+        std::set<int> current;
+
+        explicit iterator(const CliqueFamily* family) : family(family), choice(family->nodes.size(), 0) {
+            resolve();
+        }
+
+        void resolve() {
+            current.clear();
+            std::vector<int> active;
+            family->walk(choice, active, current);
+        }
+
+        void advance() {
+            std::vector<int> active;
+            std::set<int> unused;
+            family->walk(choice, active, unused);
+            for (size_t i = active.size(); i-- > 0;) {
+                int id = active[i];
+                if (choice[id] + 1 < static_cast<int>(family->nodes[id].children.size())) {
+                    choice[id]++;
+                    for (size_t j = i + 1; j < active.size(); ++j) {
+                        choice[active[j]] = 0;
+                    }
+                    resolve();
+                    return;
+                }
+            }
+            family = nullptr;
+            choice.clear();
+            current.clear();
+        }
+    };
+
+    iterator begin() const {
+        return iterator(this);
+    }
+
+    iterator end() const {
+        return iterator();
+    }
+
+    /**
+     * @brief Returns the number of cliques in the family, without expanding them.
+     * @return The count, saturated at the largest uint64_t.
+     */
+    uint64_t count() const {
+        uint64_t total = 1;
+        for (int root : roots) {
+            total = saturating_multiply(total, count(root));
+        }
+        return total;
+    }
+
+    /**
+     * @brief Returns the cliques of the family as a vector of sets.
+     */
+    std::vector<std::set<int>> expand() const {
+        return std::vector<std::set<int>>(begin(), end());
+    }
+
+    /**
+     * @brief Formats the family: space-separated factors, where a factor is a vertex in every clique
+     *        or "{a,b,...}" for a choice of one alternative, and a composite alternative is a
+     *        parenthesized product. K(3,3) is "{0,1,2} {3,4,5}"; a single clique prints as its vertices.
+     */
+    std::string to_string() const {
+        std::string text;
+        for (int root : roots) {
+            append_factors(root, text);
+        }
+        return text;
+    }
+
+private:
+    friend class TwinReduction;
+    // The twin trees of the family; children refer to indices in this vector.
+    std::vector<TwinNode> nodes;
+    std::vector<int> roots;
+
+    static uint64_t saturating_multiply(uint64_t a, uint64_t b) {
+        if (a != 0 && b > std::numeric_limits<uint64_t>::max() / a) return std::numeric_limits<uint64_t>::max();
+        return a * b;
+    }
+
+    uint64_t count(int id) const {
+        const TwinNode& n = nodes[id];
+        uint64_t total = n.kind == TwinNode::Kind::Any ? 0 : 1;
+        for (int child : n.children) {
+            if (n.kind == TwinNode::Kind::All) {
+                total = saturating_multiply(total, count(child));
+            } else {
+                uint64_t c = count(child);
+                total = total > std::numeric_limits<uint64_t>::max() - c ? std::numeric_limits<uint64_t>::max() : total + c;
+            }
+        }
+        return total;
+    }
+
+    // Collects the vertices selected by 'choice', and the Any nodes on the way in depth-first order.
+    void walk(const std::vector<int>& choice, std::vector<int>& active, std::set<int>& vertices) const {
+        std::vector<int> stack(roots.rbegin(), roots.rend());
+        while (!stack.empty()) {
+            int id = stack.back();
+            stack.pop_back();
+            const TwinNode& n = nodes[id];
+            switch (n.kind) {
+                case TwinNode::Kind::Vertex:
+                    vertices.insert(n.vertex);
+                    break;
+                case TwinNode::Kind::All:
+                    stack.insert(stack.end(), n.children.rbegin(), n.children.rend());
+                    break;
+                case TwinNode::Kind::Any:
+                    active.push_back(id);
+                    stack.push_back(n.children[choice[id]]);
+                    break;
+            }
+        }
+    }
+
+    void append_factors(int id, std::string& text) const {
+        const TwinNode& n = nodes[id];
+        if (n.kind == TwinNode::Kind::All) {
+            for (int child : n.children) {
+                append_factors(child, text);
+            }
+            return;
+        }
+        if (!text.empty() && text.back() != '(' && text.back() != '{' && text.back() != ',') {
+            text += ' ';
+        }
+        if (n.kind == TwinNode::Kind::Vertex) {
+            text += std::to_string(n.vertex);
+            return;
+        }
+        text += '{';
+        for (size_t i = 0; i < n.children.size(); ++i) {
+            if (i > 0) text += ',';
+            bool composite = nodes[n.children[i]].kind == TwinNode::Kind::All;
+            if (composite) text += '(';
+            append_factors(n.children[i], text);
+            if (composite) text += ')';
+        }
+        text += '}';
+    }
+};
+
+/**
+ * @brief Symmetry reduction by twin classes.
+ * @brief True twins always appear together in maximal cliques, and false twins are interchangeable
+ *        in them, so merging each twin class into a single vertex keeps a one-to-one map between the
+ *        maximal cliques of the reduced graph and orbits of maximal cliques of the original graph.
+ *        Merging can create new twins, so both reductions are repeated until neither applies; a
+ *        cograph (e.g. a complete multipartite graph) reduces to a single vertex.
+ * @note Time Complexity: O(n^2 / 64) per round to find the twin classes, plus O(q^2) to build the
+ *       q-vertex reduced graph.
+ */
+class TwinReduction {
+public:
+    // The reduced graph. Vertex q stands for the twin tree rooted at node(q).
+    Graph quotient;
+
+    /**
+     * @brief Constructor for the TwinReduction class; computes the reduced graph of g.
+     */
+    explicit TwinReduction(const Graph& g) : quotient(g) {
+        for (int v = 0; v < g.num_vertices; ++v) {
+            nodes.push_back(TwinNode{TwinNode::Kind::Vertex, v, {}});
+            node_of.push_back(v);
+        }
+        bool changed = true;
+        while (changed) {
+            changed = merge_twins(true);
+            changed = merge_twins(false) || changed;
+        }
+    }
+
+    /**
+     * @brief Returns the twin tree node that reduced vertex q stands for.
+     */
+    const TwinNode& node(int q) const {
+        return nodes[node_of[q]];
+    }
+
+    /**
+     * @brief Returns the original vertices merged into reduced vertex q, in increasing order.
+     */
+    std::vector<int> members(int q) const {
+        std::vector<int> result;
+        collect_members(node_of[q], result);
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    /**
+     * @brief Finds the maximal cliques of the reduced graph, one per orbit of maximal cliques of the original graph.
+     * @return Cliques of reduced vertex ids; expand them with for_each_expansion.
+     */
+    std::vector<std::vector<int>> find_max_clique_orbits() {
+        std::vector<std::vector<int>> orbits;
+        CliqueSearchStats stats;
+        quotient.for_each_max_clique(
+            [&](const std::set<int>& clique) { orbits.emplace_back(clique.begin(), clique.end()); },
+            CliqueSearchOptions(), stats, TomitaPivot());
+        return orbits;
+    }
+
+    /**
+     * @brief Calls on_clique for every maximal clique of the original graph in the given orbit.
+     * @param orbit A maximal clique of the reduced graph.
+     * @param on_clique Called once per clique, with original vertex ids.
+     */
+    void for_each_expansion(const std::vector<int>& orbit, const CliqueCallback& on_clique) const {
+        std::vector<int> pending, chosen;
+        for (int q : orbit) {
+            pending.push_back(node_of[q]);
+        }
+        expand(pending, chosen, on_clique);
+    }
+
+    /**
+     * @brief Streams the maximal cliques of the original graph, enumerating only the reduced graph.
+     * @param on_clique Called once per maximal clique of the original graph, with original vertex ids.
+     * @param stats Receives the instrumentation counters of the search on the reduced graph.
+     * @param pivot The pivot policy of the search.
+     */
+    template <typename PivotPolicy = TomitaPivot>
+    void for_each_max_clique(const CliqueCallback& on_clique, CliqueSearchStats& stats,
+                             PivotPolicy pivot = PivotPolicy()) {
+        quotient.for_each_max_clique(
+            [&](const std::set<int>& clique) {
+                for_each_expansion(std::vector<int>(clique.begin(), clique.end()), on_clique);
+            },
+            CliqueSearchOptions(), stats, pivot);
+    }
+
+    /**
+     * @brief Returns the family of maximal cliques of the original graph in the given orbit.
+     * @param orbit A maximal clique of the reduced graph.
+     */
+    CliqueFamily family(const std::vector<int>& orbit) const {
+        CliqueFamily result;
+        for (int q : orbit) {
+            result.roots.push_back(copy_tree(node_of[q], result.nodes));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Streams the maximal cliques of the original graph as families, one per maximal clique
+     *        of the reduced graph, without expanding them.
+     * @param on_family Called once per family.
+     * @param stats Receives the instrumentation counters of the search on the reduced graph.
+     * @param pivot The pivot policy of the search.
+     */
+    template <typename PivotPolicy = TomitaPivot>
+    void for_each_clique_family(const std::function<void(const CliqueFamily&)>& on_family, CliqueSearchStats& stats,
+                                PivotPolicy pivot = PivotPolicy()) {
+        quotient.for_each_max_clique(
+            [&](const std::set<int>& clique) { on_family(family(std::vector<int>(clique.begin(), clique.end()))); },
+            CliqueSearchOptions(), stats, pivot);
+    }
+
+    /**
+     * @brief Counts the maximal cliques of the original graph without expanding any of them.
+     * @return The count, saturated at the largest uint64_t.
+     */
+    uint64_t count_max_cliques() {
+        uint64_t total = 0;
+        CliqueSearchStats stats;
+        for_each_clique_family([&](const CliqueFamily& f) {
+            uint64_t c = f.count();
+            total = total > std::numeric_limits<uint64_t>::max() - c ? std::numeric_limits<uint64_t>::max() : total + c;
+        }, stats);
+        return total;
+    }
+
+private:
+    std::vector<TwinNode> nodes;
+    // The twin tree node of every reduced vertex.
+    std::vector<int> node_of;
+
+    // Copies the twin tree rooted at 'id' into 'out' and returns the index of its root there.
+    int copy_tree(int id, std::vector<TwinNode>& out) const {
+        TwinNode copy = nodes[id];
+        for (int& child : copy.children) {
+            child = copy_tree(child, out);
+        }
+        out.push_back(std::move(copy));
+        return static_cast<int>(out.size()) - 1;
+    }
+
+    void collect_members(int id, std::vector<int>& result) const {
+        const TwinNode& n = nodes[id];
+        if (n.kind == TwinNode::Kind::Vertex) {
+            result.push_back(n.vertex);
+        }
+        for (int child : n.children) {
+            collect_members(child, result);
+        }
+    }
+
+    // Enumerates every way of resolving the pending nodes into original vertices.
+    void expand(std::vector<int>& pending, std::vector<int>& chosen, const CliqueCallback& on_clique) const {
+        if (pending.empty()) {
+            on_clique(std::set<int>(chosen.begin(), chosen.end()));
+            return;
+        }
+        int id = pending.back();
+        pending.pop_back();
+        const TwinNode& n = nodes[id];
+        switch (n.kind) {
+            case TwinNode::Kind::Vertex:
+                chosen.push_back(n.vertex);
+                expand(pending, chosen, on_clique);
+                chosen.pop_back();
+                break;
+            case TwinNode::Kind::All:
+                pending.insert(pending.end(), n.children.begin(), n.children.end());
+                expand(pending, chosen, on_clique);
+                pending.resize(pending.size() - n.children.size());
+                break;
+            case TwinNode::Kind::Any:
+                for (int child : n.children) {
+                    pending.push_back(child);
+                    expand(pending, chosen, on_clique);
+                    pending.pop_back();
+                }
+                break;
+        }
+        pending.push_back(id);
+    }
+
+    // Merges the classes of true twins (closed = true) or false twins of the reduced graph.
+    // Returns whether any class had more than one vertex.
+    bool merge_twins(bool closed) {
+        int q = quotient.num_vertices;
+        // Vertices bucketed by a hash of their neighborhood, then split into classes of equal ones.
+        std::unordered_map<uint64_t, std::vector<int>> buckets;
+        std::vector<std::vector<uint64_t>> rows(quotient.adj_bits);
+        std::vector<int> class_of(q, -1);
+        std::vector<std::vector<int>> classes;
+        for (int v = 0; v < q; ++v) {
+            if (closed) {
+                rows[v][v / 64] |= uint64_t(1) << (v % 64);
+            }
+            uint64_t hash = 14695981039346656037ull;
+            for (uint64_t word : rows[v]) {
+                hash = (hash ^ word) * 1099511628211ull;
+            }
+            std::vector<int>& bucket = buckets[hash];
+            for (int u : bucket) {
+                if (rows[u] == rows[v]) {
+                    class_of[v] = class_of[u];
+                    break;
+                }
+            }
+            if (class_of[v] < 0) {
+                class_of[v] = static_cast<int>(classes.size());
+                classes.emplace_back();
+                bucket.push_back(v);
+            }
+            classes[class_of[v]].push_back(v);
+        }
+        if (static_cast<int>(classes.size()) == q) {
+            return false;
+        }
+
+        std::vector<int> new_node_of;
+        for (const auto& members : classes) {
+            if (members.size() == 1) {
+                new_node_of.push_back(node_of[members[0]]);
+                continue;
+            }
+            TwinNode merged{closed ? TwinNode::Kind::All : TwinNode::Kind::Any, -1, {}};
+            for (int v : members) {
+                merged.children.push_back(node_of[v]);
+            }
+            new_node_of.push_back(static_cast<int>(nodes.size()));
+            nodes.push_back(std::move(merged));
+        }
+        Graph reduced(static_cast<int>(classes.size()));
+        for (size_t a = 0; a < classes.size(); ++a) {
+            for (size_t b = a + 1; b < classes.size(); ++b) {
+                if (quotient.adj_matrix[classes[a][0]][classes[b][0]]) {
+                    reduced.add_edge(static_cast<int>(a), static_cast<int>(b));
+                }
+            }
+        }
+        quotient = std::move(reduced);
+        node_of = std::move(new_node_of);
+        return true;
+    }
+};
+
+#endif  // TWIN_REDUCTION_H